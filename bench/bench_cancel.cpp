@@ -0,0 +1,54 @@
+// 比较立即删除与延迟取消 (墓碑 + 压缩): N 个一小时后到期的定时器, 每次操作取消一个随机定时器并新建一个
+// 模拟绝大多数定时器在到期前被取消的负载, 输出每次操作 (cancel + schedule) 的平均耗时
+
+#include <simple_timer/timer_scheduler.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+template <typename Scheduler>
+double ns_per_op(TimerCancelMode mode, std::size_t n, std::size_t ops, TimerSchedulerStats &stats)
+{
+  Scheduler scheduler;
+  scheduler.set_cancel_mode(mode);
+  std::mt19937_64 rng(2024);
+  std::vector<TimerId> ids(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    ids[i] = scheduler.schedule_after(std::chrono::hours(1) + std::chrono::milliseconds(rng() % 60000), []() {});
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t k = 0; k < ops; ++k)
+  {
+    const std::size_t i = static_cast<std::size_t>(rng() % n);
+    scheduler.cancel(ids[i]);
+    ids[i] = scheduler.schedule_after(std::chrono::hours(1) + std::chrono::milliseconds(rng() % 60000), []() {});
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  stats = scheduler.stats();
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+         static_cast<double>(ops);
+}
+}  // namespace
+
+int main()
+{
+  std::printf("%10s %14s %14s %12s %12s\n", "timers", "eager ns/op", "lazy ns/op", "compactions", "tombstones");
+  for (std::size_t n = 1000; n <= 1000000; n *= 10)
+  {
+    TimerSchedulerStats eager_stats;
+    TimerSchedulerStats lazy_stats;
+    const std::size_t ops = 1000000;
+    const double eager = ns_per_op<TimerScheduler>(TimerCancelMode::Eager, n, ops, eager_stats);
+    const double lazy = ns_per_op<TimerScheduler>(TimerCancelMode::Lazy, n, ops, lazy_stats);
+    std::printf("%10zu %14.1f %14.1f %12llu %12zu\n", n, eager, lazy,
+                static_cast<unsigned long long>(lazy_stats.compactions), lazy_stats.tombstones);
+  }
+  return 0;
+}
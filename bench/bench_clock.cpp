@@ -0,0 +1,45 @@
+// 测量各时钟源每次 now() 调用的耗时 (纳秒)
+
+#include <simple_timer/timer_clock.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+template <typename Clock>
+double ns_per_call(std::size_t calls)
+{
+  std::int64_t sink = 0;  // 防止调用被优化掉
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < calls; ++i)
+  {
+    sink += Clock::now().time_since_epoch().count();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  if (sink == 42)
+  {
+    std::printf("\n");
+  }
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+         static_cast<double>(calls);
+}
+}  // namespace
+
+int main()
+{
+  const std::size_t calls = 20000000;
+  std::printf("invariant TSC: %s, calibrated: %s, frequency: %.0f MHz\n", TscClock::invariant() ? "yes" : "no",
+              TscClock::calibrated() ? "yes" : "no", TscClock::frequency() / 1e6);
+
+  std::printf("%-28s %10s\n", "clock", "ns/call");
+  std::printf("%-28s %10.2f\n", "std::chrono::steady_clock", ns_per_call<std::chrono::steady_clock>(calls));
+  std::printf("%-28s %10.2f\n", "std::chrono::system_clock", ns_per_call<std::chrono::system_clock>(calls));
+  std::printf("%-28s %10.2f\n", "CoarseSteadyClock", ns_per_call<CoarseSteadyClock>(calls));
+  std::printf("%-28s %10.2f\n", "TscClock", ns_per_call<TscClock>(calls));
+  std::printf("%-28s %10.2f\n", "CachedClock<> (not cached)", ns_per_call<CachedClock<>>(calls));
+  CachedClock<>::refresh();  // 之后本线程读取缓存, 与调度线程相同
+  std::printf("%-28s %10.2f\n", "CachedClock<> (cached)", ns_per_call<CachedClock<>>(calls));
+  return 0;
+}
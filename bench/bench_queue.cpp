@@ -0,0 +1,141 @@
+// 比较 TimerHeap 与 FlatTimerQueue: N 个周期为 1~P tick 的定时器, 每个 tick 取出到期节点并重新入队
+// P = 4 时大部分定时器每个 tick 都会重新调度, P = 1024 时每个 tick 只有少量到期
+// 输出每个 tick 的平均耗时, 以及 TimerHeap 开始占优的交叉点
+// 另外用 hold 模型比较 TimerHeap 与 LadderTimerQueue: 每次取出最早的定时器, 再以 1 秒 ~ 1 天的对数均匀分布重新入队
+// 用法: bench_queue [hold 模型的最大定时器数, 默认 1000000]
+
+#include <simple_timer/timer_queue.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+struct BenchNode : TimerNode
+{
+  std::int64_t period{1};
+};
+
+template <typename Queue>
+double ns_per_tick(std::size_t n, std::int64_t max_period, std::int64_t ticks)
+{
+  std::vector<BenchNode> nodes(n);
+  std::mt19937 rng(12345);
+  Queue queue;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    nodes[i].id = i + 1;
+    nodes[i].period = 1 + static_cast<std::int64_t>(rng()) % max_period;
+    nodes[i].deadline = 1 + static_cast<std::int64_t>(rng()) % max_period;
+    queue.push(&nodes[i]);
+  }
+
+  std::vector<TimerNode *> due;
+  std::size_t fired = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::int64_t now = 1; now <= ticks; ++now)
+  {
+    due.clear();
+    queue.pop_expired(now, due);
+    fired += due.size();
+    for (TimerNode *node : due)
+    {
+      node->deadline += static_cast<BenchNode *>(node)->period;
+      queue.push(node);
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  if (fired == 0)
+  {
+    std::printf("no timer fired\n");
+  }
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+         static_cast<double>(ticks);
+}
+/// @brief hold 模型: 每次操作取出一个到期定时器并重新入队, 返回每次操作的平均耗时
+template <typename Queue>
+double ns_per_hold(std::size_t n, std::size_t ops)
+{
+  std::vector<TimerNode> nodes(n);
+  std::mt19937_64 rng(4242);
+  std::uniform_real_distribution<double> exponent(9.0, 13.94);  // 10^9 ns (1 秒) ~ 8.64 * 10^13 ns (1 天)
+  Queue queue;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    nodes[i].id = i + 1;
+    nodes[i].deadline = static_cast<std::int64_t>(std::pow(10.0, exponent(rng)));
+    queue.push(&nodes[i]);
+  }
+
+  std::vector<TimerNode *> due;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t k = 0; k < ops; ++k)
+  {
+    const std::int64_t now = queue.earliest();
+    due.clear();
+    queue.pop_expired(now, due);
+    for (TimerNode *node : due)
+    {
+      node->deadline = now + static_cast<std::int64_t>(std::pow(10.0, exponent(rng)));
+      queue.push(node);
+    }
+    k += due.size() - 1;
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+         static_cast<double>(ops);
+}
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  const std::size_t max_hold = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 1000000;
+
+#if !defined(SIMPLE_TIMER_NO_SIMD) && defined(__AVX2__)
+  std::printf("FlatTimerQueue scan: AVX2\n");
+#elif !defined(SIMPLE_TIMER_NO_SIMD) && defined(__SSE4_2__)
+  std::printf("FlatTimerQueue scan: SSE4.2\n");
+#else
+  std::printf("FlatTimerQueue scan: scalar\n");
+#endif
+  const std::int64_t periods[] = {4, 1024};
+  for (std::int64_t max_period : periods)
+  {
+    std::printf("\nperiods 1..%lld ticks\n", static_cast<long long>(max_period));
+    std::printf("%10s %16s %16s\n", "timers", "heap ns/tick", "flat ns/tick");
+    std::size_t crossover = 0;
+    for (std::size_t n = 16; n <= 65536; n *= 2)
+    {
+      const std::int64_t ticks = static_cast<std::int64_t>(4000000 / n) + 100;
+      const double heap = ns_per_tick<TimerHeap>(n, max_period, ticks);
+      const double flat = ns_per_tick<FlatTimerQueue>(n, max_period, ticks);
+      std::printf("%10zu %16.1f %16.1f\n", n, heap, flat);
+      if (crossover == 0 && heap < flat)
+      {
+        crossover = n;
+      }
+    }
+    if (crossover != 0)
+    {
+      std::printf("crossover: TimerHeap is faster from %zu timers\n", crossover);
+    }
+    else
+    {
+      std::printf("crossover: none, FlatTimerQueue is faster at every size measured\n");
+    }
+  }
+
+  std::printf("\nhold model, deadlines 1 s .. 1 day (log-uniform)\n");
+  std::printf("%10s %16s %16s\n", "timers", "heap ns/op", "ladder ns/op");
+  for (std::size_t n = 10000; n <= max_hold; n *= 10)
+  {
+    const std::size_t ops = 2000000;
+    std::printf("%10zu %16.1f %16.1f\n", n, ns_per_hold<TimerHeap>(n, ops), ns_per_hold<LadderTimerQueue>(n, ops));
+  }
+  return 0;
+}
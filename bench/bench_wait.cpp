@@ -0,0 +1,64 @@
+// 比较 SimpleTimer 两种等待方式的触发抖动: 条件变量 wait_until 与按绝对时间睡眠 (TimerWaitStrategy::AbsoluteSleep)
+// 每次触发记录相对理想时间点 (start + k * interval) 的延迟, 输出 p50 / p99 / 最大值 (微秒)
+// 用法: bench_wait [间隔微秒, 默认 1000] [触发次数, 默认 2000]
+
+#include <simple_timer/simple_timer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace
+{
+void run(const char *name, TimerWaitStrategy strategy, std::chrono::microseconds interval, std::size_t fires)
+{
+  using clock = std::chrono::steady_clock;
+  std::vector<clock::time_point> stamps;
+  stamps.reserve(fires);
+  std::atomic<bool> done{false};
+
+  SimpleTimer timer(interval);
+  timer.set_wait_strategy(strategy);
+  const clock::time_point start = clock::now();
+  timer.start([&]() {
+    stamps.push_back(clock::now());
+    if (stamps.size() == fires)
+    {
+      done = true;
+      return TimerAction::Stop;
+    }
+    return TimerAction::Continue;
+  });
+  while (!done)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  timer.stop();
+
+  std::vector<double> lateness;
+  for (std::size_t k = 0; k < stamps.size(); ++k)
+  {
+    const clock::time_point ideal = start + interval * static_cast<long long>(k + 1);
+    lateness.push_back(std::chrono::duration<double, std::micro>(stamps[k] - ideal).count());
+  }
+  std::sort(lateness.begin(), lateness.end());
+  std::printf("%-20s %10.1f %10.1f %10.1f\n", name, lateness[lateness.size() / 2],
+              lateness[lateness.size() * 99 / 100], lateness.back());
+}
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  const std::chrono::microseconds interval(argc > 1 ? std::atoll(argv[1]) : 1000);
+  const std::size_t fires = argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 2000;
+  std::printf("interval %lld us, %zu fires, lateness in us (the first fire is measured from start())\n",
+              static_cast<long long>(interval.count()), fires);
+  std::printf("%-20s %10s %10s %10s\n", "wait strategy", "p50", "p99", "max");
+  run("condition_variable", TimerWaitStrategy::ConditionVariable, interval, fires);
+  run("absolute sleep", TimerWaitStrategy::AbsoluteSleep, interval, fires);
+  return 0;
+}
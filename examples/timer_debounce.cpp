@@ -0,0 +1,30 @@
+#include <simple_timer/debounce.h>
+
+#include <iostream>
+
+int64_t get_ms()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+    .count();
+}
+
+int main()
+{
+  TimerScheduler scheduler;
+
+  // 防抖: 输入停止 200ms 后才保存
+  Debouncer save(scheduler, std::chrono::milliseconds(200), []() { std::cout << get_ms() % 100000 << ": save\n"; });
+  // 节流: 每 100ms 最多刷新一次界面
+  Throttler redraw(scheduler, std::chrono::milliseconds(100),
+                   []() { std::cout << get_ms() % 100000 << ": redraw\n"; });
+
+  for (int i = 0; i < 50; ++i)  // 模拟 500ms 内的连续输入事件
+  {
+    save.trigger();    // 每个事件只是一次原子写
+    redraw.trigger();  // 不会重启线程, 也不会触碰定时器队列
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  return 0;
+}
@@ -0,0 +1,18 @@
+// 最小化构建示例: 不使用 iostream/cstdio, 可在 -fno-exceptions 下编译
+// 例如: c++ -std=c++11 -Os -fno-exceptions -DSIMPLE_TIMER_MINIMAL -Iinclude examples/timer_minimal.cpp -pthread
+#include <simple_timer/simple_timer.h>
+
+#include <atomic>
+
+int main()
+{
+  std::atomic<int> counter{0};
+  SimpleTimer timer(std::chrono::milliseconds(20));
+
+  timer.start([&counter]() { return ++counter == 5 ? TimerAction::Stop : TimerAction::Continue; });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  timer.stop();
+
+  return counter == 5 ? 0 : 1;
+}
@@ -0,0 +1,35 @@
+#include <simple_timer/simple_timer.h>
+
+#include <algorithm>
+#include <iostream>
+
+int64_t get_ms()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+    .count();
+}
+
+int main()
+{
+  // 自适应轮询: 没有数据时逐步退避, 有数据时立即加快, 由任务返回值决定下一次触发时间
+  SimpleTimer poller(std::chrono::milliseconds(100));
+  std::chrono::milliseconds backoff(50);
+  int polls = 0;
+
+  poller.start([&]() -> TimerNext {
+    ++polls;
+    bool has_data = (polls % 5 == 0);  // 模拟每 5 次轮询才有一次数据
+    backoff = has_data ? std::chrono::milliseconds(50) : std::min(backoff * 2, std::chrono::milliseconds(800));
+    std::cout << get_ms() % 100000 << ": poll #" << polls << (has_data ? " got data" : " idle") << ", next in "
+              << backoff.count() << "ms\n";
+    if (polls == 12)
+    {
+      return TimerAction::Stop;  // 主动结束
+    }
+    return backoff;  // 等同于 TimerAction::RescheduleIn
+  });
+
+  std::this_thread::sleep_for(std::chrono::seconds(6));
+  std::cout << "poller stopped: " << std::boolalpha << poller.is_stopped() << '\n';
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include <simple_timer/timer_scheduler.h>
+
+#include <iostream>
+
+int64_t get_ms()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+    .count();
+}
+
+int main()
+{
+  // 一个调度器线程服务所有定时器, 每个定时器只占用一个队列节点
+  TimerScheduler scheduler;
+
+  scheduler.schedule_every(std::chrono::milliseconds(300),
+                           []() { std::cout << get_ms() % 100000 << ": every 300ms\n"; });
+  scheduler.schedule_after(std::chrono::seconds(1), []() { std::cout << get_ms() % 100000 << ": once after 1s\n"; });
+
+  // cron 表达式: 每分钟的第 0 秒触发 (UTC)
+  scheduler.schedule_cron(CronExpr("* * * * *"), []() { std::cout << get_ms() % 100000 << ": cron every minute\n"; });
+
+  // 可取消的定时器
+  TimerId id = scheduler.schedule_every(std::chrono::milliseconds(100), []() { std::cout << "  fast tick\n"; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(450));
+  scheduler.cancel(id);
+
+  std::this_thread::sleep_for(std::chrono::seconds(2));
+  std::cout << "live timers: " << scheduler.size() << '\n';
+  return 0;
+}
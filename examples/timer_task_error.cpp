@@ -38,5 +38,16 @@ int main()
   timer.stop();
   std::cout << "Timer stopped after 5 seconds.\n";
 
+  // 自定义异常策略: 出错后按 100ms, 200ms, 400ms... 退避重试, 不再停止定时器
+  SimpleTimer retry_timer(std::chrono::milliseconds(100));
+  retry_timer.set_error_handler(TimerErrorPolicy::backoff(std::chrono::milliseconds(100), std::chrono::seconds(1)));
+  retry_timer.start([]() {
+    std::cout << get_ms() % 100000 << ": retry task failed\n";
+    throw std::runtime_error("still failing");
+  });
+  std::this_thread::sleep_for(std::chrono::seconds(3));
+  retry_timer.stop();
+  std::cout << "retry timer errors: " << retry_timer.errors() << '\n';
+
   return 0;
 }
@@ -0,0 +1,428 @@
+/**
+ * @file: cron_expr.h
+ * @description: Compiled cron expression. The five fields (minute, hour, day of month, month, day of week) are parsed
+ *               once into bitsets; the next fire time is found with a handful of bit scans, without per-minute polling.
+ *
+ * - Syntax:
+ *    - `*`, `a`, `a-b`, `*\/n`, `a-b/n`, `a/n` and comma separated lists of those, e.g. `0,30 9-17 * * MON-FRI`.
+ *    - Month and weekday names (`JAN`..`DEC`, `SUN`..`SAT`, case-insensitive); weekday `7` is an alias of Sunday.
+ *    - Macros: `@yearly`, `@annually`, `@monthly`, `@weekly`, `@daily`, `@midnight`, `@hourly`.
+ *    - Like Vixie cron, when both day of month and day of week are restricted, a day matching either one fires.
+ *    - Times are evaluated in UTC, optionally shifted by a fixed offset (no time zone database involved).
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_CRON_EXPR_H
+#define SIMPLE_TIMER_CRON_EXPR_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "timer_math.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace simple_timer
+{
+namespace detail
+{
+/// @brief 最低位 1 的位置 (x != 0)
+inline int ctz64(std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index = 0;
+  _BitScanForward64(&index, x);
+  return static_cast<int>(index);
+#else
+  int n = 0;
+  while ((x & 1U) == 0)
+  {
+    x >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+/// @brief 查找 mask 中不小于 from 的第一个置位, 不存在时返回 -1
+inline int next_bit(std::uint64_t mask, int from)
+{
+  if (from >= 64)
+  {
+    return -1;
+  }
+  const std::uint64_t m = mask & (~std::uint64_t(0) << from);
+  return m == 0 ? -1 : ctz64(m);
+}
+
+/// @brief 公历日期转自 1970-01-01 起的天数 (Howard Hinnant 的 days_from_civil 算法)
+inline std::int64_t days_from_civil(std::int64_t y, unsigned m, unsigned d)
+{
+  y -= m <= 2 ? 1 : 0;
+  const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+/// @brief 自 1970-01-01 起的天数转公历日期
+inline void civil_from_days(std::int64_t z, std::int64_t &y, unsigned &m, unsigned &d)
+{
+  z += 719468;
+  const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const unsigned doe = static_cast<unsigned>(z - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+}
+
+/// @brief 某月的天数
+inline unsigned days_in_month(std::int64_t y, unsigned m)
+{
+  static const unsigned kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+  return m == 2 && leap ? 29 : kDays[m - 1];
+}
+}  // namespace detail
+}  // namespace simple_timer
+
+/// @brief A cron expression compiled into bitsets
+class CronExpr
+{
+ public:
+  /// @brief Constructs an invalid expression that never fires
+  CronExpr() = default;
+
+  /// @brief Parses a five-field cron expression or a macro such as `@daily`
+  /// @param expr The expression text; check `valid()` afterwards
+  explicit CronExpr(const std::string &expr)
+  {
+    valid_ = parse(expr);
+  }
+
+  /// @brief Checks if the expression was parsed successfully
+  bool valid() const
+  {
+    return valid_;
+  }
+
+  /// @brief Computes the first fire time strictly after `after`
+  /// @param after The reference time point
+  /// @param utc_offset Fixed offset of the evaluation time zone from UTC, e.g. `std::chrono::hours(8)`
+  /// @return The next fire time (whole minute), or `time_point::max()` if the expression never fires
+  std::chrono::system_clock::time_point next(
+    std::chrono::system_clock::time_point after, std::chrono::minutes utc_offset = std::chrono::minutes(0)) const
+  {
+    using std::chrono::system_clock;
+    using simple_timer::detail::next_bit;
+    if (!valid_)
+    {
+      return system_clock::time_point::max();
+    }
+
+    // 转换为本地分钟数, 从下一整分钟开始查找
+    const auto since_epoch = after.time_since_epoch();
+    std::int64_t secs = std::chrono::duration_cast<std::chrono::seconds>(since_epoch).count();
+    if (std::chrono::seconds(secs) > since_epoch)
+    {
+      --secs;  // 向下取整
+    }
+    const std::int64_t local_min = simple_timer::detail::floor_div(secs, 60) + utc_offset.count() + 1;
+    const std::int64_t day0 = simple_timer::detail::floor_div(local_min, 1440);
+    const std::int64_t min_of_day = local_min - day0 * 1440;
+
+    std::int64_t y = 0;
+    unsigned m = 0;
+    unsigned d = 0;
+    simple_timer::detail::civil_from_days(day0, y, m, d);
+    int hh = static_cast<int>(min_of_day / 60);
+    int mi = static_cast<int>(min_of_day % 60);
+    const std::int64_t year_limit = y + 8;  // 2月29日最长 8 年出现一次, 超过则认为永不触发
+
+    while (y <= year_limit)
+    {
+      const int month = next_bit(months_, static_cast<int>(m));
+      if (month < 0)
+      {
+        ++y, m = 1, d = 1, hh = 0, mi = 0;
+        continue;
+      }
+      if (static_cast<unsigned>(month) != m)
+      {
+        m = static_cast<unsigned>(month), d = 1, hh = 0, mi = 0;
+      }
+
+      const int day = next_bit(day_mask(y, m), static_cast<int>(d));
+      if (day < 0)
+      {
+        ++m, d = 1, hh = 0, mi = 0;  // m == 13 时下一轮 next_bit 找不到月份, 自动进入下一年
+        continue;
+      }
+      if (static_cast<unsigned>(day) != d)
+      {
+        d = static_cast<unsigned>(day), hh = 0, mi = 0;
+      }
+
+      const int hour = next_bit(hours_, hh);
+      if (hour < 0)
+      {
+        ++d, hh = 0, mi = 0;
+        continue;
+      }
+      if (hour != hh)
+      {
+        hh = hour, mi = 0;
+      }
+
+      const int minute = next_bit(minutes_, mi);
+      if (minute < 0)
+      {
+        ++hh, mi = 0;
+        continue;
+      }
+
+      const std::int64_t total_min =
+        simple_timer::detail::days_from_civil(y, m, d) * 1440 + hh * 60 + minute - utc_offset.count();
+      return system_clock::time_point(
+        std::chrono::duration_cast<system_clock::duration>(std::chrono::minutes(total_min)));
+    }
+    return system_clock::time_point::max();
+  }
+
+ private:
+  /// @brief 计算某年某月满足日期/星期条件的日期位图 (bit 1..31)
+  std::uint64_t day_mask(std::int64_t y, unsigned m) const
+  {
+    const unsigned dim = simple_timer::detail::days_in_month(y, m);
+    const std::uint64_t valid = ((std::uint64_t(1) << dim) - 1) << 1;
+    if (dom_star_ && dow_star_)
+    {
+      return valid;
+    }
+    // 1 号是星期几 (0 = 星期日), 把星期位图旋转成"相对 1 号的偏移"再平铺到整月
+    const std::int64_t days = simple_timer::detail::days_from_civil(y, m, 1);
+    const unsigned wd1 = static_cast<unsigned>(((days + 4) % 7 + 7) % 7);  // 1970-01-01 是星期四
+    std::uint64_t pattern = 0;
+    for (unsigned j = 0; j < 7; ++j)
+    {
+      if (dow_ & (1U << ((wd1 + j) % 7)))
+      {
+        pattern |= std::uint64_t(1) << j;
+      }
+    }
+    std::uint64_t dow_days = 0;
+    for (unsigned week = 0; week < 5; ++week)
+    {
+      dow_days |= pattern << (1 + 7 * week);
+    }
+    dow_days &= valid;
+    const std::uint64_t dom_days = dom_ & valid;
+    if (dom_star_)
+    {
+      return dow_days;
+    }
+    if (dow_star_)
+    {
+      return dom_days;
+    }
+    return dom_days | dow_days;  // 两者都受限时取并集 (Vixie cron 语义)
+  }
+
+  /// @brief 解析完整表达式
+  bool parse(const std::string &expr)
+  {
+    static const struct
+    {
+      const char *name;
+      const char *expansion;
+    } kMacros[] = {
+      {"@yearly", "0 0 1 1 *"}, {"@annually", "0 0 1 1 *"}, {"@monthly", "0 0 1 * *"}, {"@weekly", "0 0 * * 0"},
+      {"@daily", "0 0 * * *"},  {"@midnight", "0 0 * * *"}, {"@hourly", "0 * * * *"},
+    };
+    std::string text = expr;
+    for (const auto &macro : kMacros)
+    {
+      if (text == macro.name)
+      {
+        text = macro.expansion;
+        break;
+      }
+    }
+
+    std::string fields[5];
+    std::size_t count = 0;
+    std::size_t pos = 0;
+    while (pos < text.size())
+    {
+      while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t'))
+      {
+        ++pos;
+      }
+      std::size_t end = pos;
+      while (end < text.size() && text[end] != ' ' && text[end] != '\t')
+      {
+        ++end;
+      }
+      if (end > pos)
+      {
+        if (count == 5)
+        {
+          return false;  // 字段过多
+        }
+        fields[count++] = text.substr(pos, end - pos);
+      }
+      pos = end;
+    }
+    if (count != 5)
+    {
+      return false;
+    }
+
+    static const char *const kMonthNames[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+                                              "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
+    static const char *const kDayNames[] = {"SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
+    std::uint64_t hours = 0;
+    std::uint64_t dom = 0;
+    std::uint64_t months = 0;
+    std::uint64_t dow = 0;
+    if (!parse_field(fields[0], 0, 59, nullptr, 0, minutes_) || !parse_field(fields[1], 0, 23, nullptr, 0, hours) ||
+        !parse_field(fields[2], 1, 31, nullptr, 0, dom) || !parse_field(fields[3], 1, 12, kMonthNames, 12, months) ||
+        !parse_field(fields[4], 0, 7, kDayNames, 7, dow))
+    {
+      return false;
+    }
+    hours_ = static_cast<std::uint32_t>(hours);
+    dom_ = static_cast<std::uint32_t>(dom);
+    months_ = static_cast<std::uint16_t>(months);
+    dow_ = static_cast<std::uint8_t>((dow | (dow >> 7)) & 0x7F);  // 7 与 0 都表示星期日
+    dom_star_ = fields[2][0] == '*';
+    dow_star_ = fields[4][0] == '*';
+    return true;
+  }
+
+  /// @brief 解析单个数值或名称, 名称 names[i] 对应数值 lo + i
+  static bool parse_value(const std::string &s, int lo, int hi, const char *const *names, int name_count, int &out)
+  {
+    if (s.empty())
+    {
+      return false;
+    }
+    for (int i = 0; i < name_count; ++i)
+    {
+      if (equals_ignore_case(s, names[i]))
+      {
+        out = lo + i;
+        return true;
+      }
+    }
+    int value = 0;
+    for (char c : s)
+    {
+      if (c < '0' || c > '9' || value > 1000)
+      {
+        return false;
+      }
+      value = value * 10 + (c - '0');
+    }
+    if (value < lo || value > hi)
+    {
+      return false;
+    }
+    out = value;
+    return true;
+  }
+
+  /// @brief 解析一个字段 (逗号分隔的列表) 为位图
+  static bool parse_field(const std::string &field, int lo, int hi, const char *const *names, int name_count,
+                          std::uint64_t &mask)
+  {
+    mask = 0;
+    std::size_t start = 0;
+    while (start <= field.size())
+    {
+      std::size_t comma = field.find(',', start);
+      if (comma == std::string::npos)
+      {
+        comma = field.size();
+      }
+      const std::string item = field.substr(start, comma - start);
+      std::string range = item;
+      int step = 1;
+      const std::size_t slash = item.find('/');
+      if (slash != std::string::npos)
+      {
+        range = item.substr(0, slash);
+        if (!parse_value(item.substr(slash + 1), 1, hi - lo + 1, nullptr, 0, step))
+        {
+          return false;
+        }
+      }
+
+      int first = lo;
+      int last = hi;
+      if (range != "*")
+      {
+        const std::size_t dash = range.find('-');
+        if (dash == std::string::npos)
+        {
+          if (!parse_value(range, lo, hi, names, name_count, first))
+          {
+            return false;
+          }
+          last = slash == std::string::npos ? first : hi;  // `a/n` 表示从 a 开始到最大值
+        }
+        else if (!parse_value(range.substr(0, dash), lo, hi, names, name_count, first) ||
+                 !parse_value(range.substr(dash + 1), lo, hi, names, name_count, last) || first > last)
+        {
+          return false;
+        }
+      }
+      for (int v = first; v <= last; v += step)
+      {
+        mask |= std::uint64_t(1) << v;
+      }
+      start = comma + 1;
+    }
+    return mask != 0;
+  }
+
+  static bool equals_ignore_case(const std::string &a, const char *b)
+  {
+    if (a.size() != std::strlen(b))
+    {
+      return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+      const char c = (a[i] >= 'a' && a[i] <= 'z') ? static_cast<char>(a[i] - 'a' + 'A') : a[i];
+      if (c != b[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::uint64_t minutes_{0};  // bit 0..59
+  std::uint32_t hours_{0};    // bit 0..23
+  std::uint32_t dom_{0};      // bit 1..31
+  std::uint16_t months_{0};   // bit 1..12
+  std::uint8_t dow_{0};       // bit 0..6, 0 = 星期日
+  bool dom_star_{false};      // 日期字段以 '*' 开头
+  bool dow_star_{false};      // 星期字段以 '*' 开头
+  bool valid_{false};         // 是否解析成功
+};
+
+#endif  // SIMPLE_TIMER_CRON_EXPR_H
@@ -0,0 +1,140 @@
+/**
+ * @file: deadline.h
+ * @description: Timeouts for in-flight operations, backed by a `TimerScheduler`.
+ *               Each operation costs one queue node: the timeout handler fires if the work has not completed by then,
+ *               and completing the work cancels the node.
+ *
+ * - Deadline: explicit `complete()` (or `wrap()` a completion callback); exactly one of "completed" and "expired" wins.
+ * - with_timeout: fires a handler if a `std::future` is not ready by the deadline. Futures cannot notify completion,
+ *   so the node stays queued until the deadline and is then a cheap no-op when the future is ready.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_DEADLINE_H
+#define SIMPLE_TIMER_DEADLINE_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+
+#include "timer_scheduler.h"
+
+/// @brief A timeout for one operation
+class Deadline
+{
+ public:
+  /// @brief Arms the deadline
+  /// @param scheduler The timer engine; must outlive the deadline
+  /// @param timeout Time allowed for the operation
+  /// @param on_timeout Handler invoked on the scheduler thread if the operation has not completed in time
+  template <typename Rep, typename Period, typename Func>
+  Deadline(TimerScheduler &scheduler, std::chrono::duration<Rep, Period> timeout, Func &&on_timeout) :
+    scheduler_(scheduler), state_(std::make_shared<State>())
+  {
+    state_->on_timeout = std::forward<Func>(on_timeout);
+    timer_ = scheduler_.schedule_after(timeout, Expiry{state_});
+  }
+
+  /// @brief Destructor. Completes the deadline so the handler can no longer fire.
+  ~Deadline()
+  {
+    complete();
+  }
+
+  Deadline(const Deadline &) = delete;
+  Deadline &operator=(const Deadline &) = delete;
+
+  /// @brief Marks the operation as finished and releases the queue node
+  /// @return true if the operation finished in time, false if the timeout already fired (or complete() was called)
+  bool complete()
+  {
+    int expected = kPending;
+    if (!state_->status.compare_exchange_strong(expected, kCompleted))
+    {
+      return false;
+    }
+    scheduler_.cancel(timer_);
+    return true;
+  }
+
+  /// @brief Checks if the timeout has fired
+  bool expired() const
+  {
+    return state_->status.load() == kExpired;
+  }
+
+  /// @brief Wraps a completion callback: calling the result completes the deadline, then forwards to `f`
+  ///        only if the operation finished in time
+  /// @note The wrapper must not be called after the Deadline is destroyed.
+  template <typename Func>
+  std::function<void()> wrap(Func &&f)
+  {
+    typename std::decay<Func>::type callback(std::forward<Func>(f));
+    return [this, callback]() mutable {
+      if (complete())
+      {
+        callback();
+      }
+    };
+  }
+
+ private:
+  enum : int
+  {
+    kPending = 0,    // 等待中
+    kCompleted = 1,  // 操作已完成
+    kExpired = 2,    // 已超时
+  };
+
+  struct State
+  {
+    std::atomic<int> status{kPending};  // 完成与超时只有一个能胜出
+    std::function<void()> on_timeout;
+  };
+
+  struct Expiry
+  {
+    std::shared_ptr<State> state;
+
+    void operator()() const
+    {
+      int expected = kPending;
+      if (state->status.compare_exchange_strong(expected, kExpired))
+      {
+        state->on_timeout();
+      }
+    }
+  };
+
+  TimerScheduler &scheduler_;
+  std::shared_ptr<State> state_;  // 与定时器任务共享
+  TimerId timer_{0};              // 超时定时器 id
+};
+
+/// @brief Fires `on_timeout` if `future` is not ready after `timeout`
+/// @param scheduler The timer engine
+/// @param future The pending result; converted to a shared future the caller keeps using
+/// @param timeout Time allowed for the result
+/// @param on_timeout Handler invoked on the scheduler thread when the future is still not ready
+/// @return The shared future, to be waited on / read by the caller
+template <typename T, typename Rep, typename Period, typename Func>
+std::shared_future<T> with_timeout(TimerScheduler &scheduler, std::future<T> future,
+                                   std::chrono::duration<Rep, Period> timeout, Func &&on_timeout)
+{
+  std::shared_future<T> shared = future.share();
+  typename std::decay<Func>::type handler(std::forward<Func>(on_timeout));
+  scheduler.schedule_after(timeout, [shared, handler]() mutable {
+    if (shared.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      handler();
+    }
+  });
+  return shared;
+}
+
+#endif  // SIMPLE_TIMER_DEADLINE_H
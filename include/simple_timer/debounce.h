@@ -0,0 +1,281 @@
+/**
+ * @file: debounce.h
+ * @description: Debounce and throttle primitives built on `TimerScheduler`.
+ *               An event costs one atomic store plus one atomic load; the shared timer is armed only when idle and
+ *               re-arms itself lazily at expiry, so bursts of events never restart threads or touch the queue.
+ *
+ * - Debouncer: runs the callback once `delay` has passed without new events (trailing edge).
+ * - Throttler: runs the callback at most once per `interval`; the first event fires right away and events arriving
+ *   during the interval are coalesced into one call at the end of it.
+ * - Callbacks run on the scheduler's dispatch thread.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_DEBOUNCE_H
+#define SIMPLE_TIMER_DEBOUNCE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "timer_scheduler.h"
+
+namespace simple_timer
+{
+namespace detail
+{
+/// @brief 布防字: 最低位表示已布防, 其余位是代数; 每次布防与每次 cancel() 代数加一.
+///        定时器任务记下布防时的布防字, 只有仍然相等时才能撤防或重新布防, 已被取消的任务不会改写新一代的状态.
+inline bool is_armed(std::uint64_t word)
+{
+  return (word & 1) != 0;
+}
+
+/// @brief 未布防时布防并进入新的一代
+/// @param word 输入: 期望的当前布防字; 输出: 成功时为新的布防字
+/// @return false 表示已布防或布防字已被修改
+inline bool try_arm(std::atomic<std::uint64_t> &armed, std::uint64_t &word)
+{
+  const std::uint64_t expected = word;
+  if (is_armed(expected) || !armed.compare_exchange_strong(word, expected + 3))
+  {
+    return false;
+  }
+  word = expected + 3;  // 代数加一并置上布防位
+  return true;
+}
+
+/// @brief 仍是 word 这一代时撤防 (代数加一)
+/// @param word 输入: 布防时的布防字; 输出: 成功时为撤防后的布防字
+inline bool try_disarm(std::atomic<std::uint64_t> &armed, std::uint64_t &word)
+{
+  const std::uint64_t expected = word;
+  if (!armed.compare_exchange_strong(word, expected + 1))
+  {
+    return false;
+  }
+  word = expected + 1;
+  return true;
+}
+
+/// @brief 无条件撤防并进入新的一代, 之前布防的任务都失效
+inline void disarm(std::atomic<std::uint64_t> &armed)
+{
+  std::uint64_t word = armed.load();
+  while (!armed.compare_exchange_weak(word, (word | 1) + 1))
+  {
+  }
+}
+}  // namespace detail
+}  // namespace simple_timer
+
+/// @brief Runs a callback after events stop arriving for a given delay
+class Debouncer
+{
+  using clock = TimerScheduler::clock;
+
+ public:
+  /// @brief Constructs a debouncer
+  /// @param scheduler The timer engine used for the delay; must outlive the debouncer
+  /// @param delay The quiet period required before the callback runs
+  /// @param f The callback, invoked on the scheduler thread
+  template <typename Rep, typename Period, typename Func>
+  Debouncer(TimerScheduler &scheduler, std::chrono::duration<Rep, Period> delay, Func &&f) :
+    scheduler_(scheduler), state_(std::make_shared<State>())
+  {
+    state_->delay = std::chrono::duration_cast<clock::duration>(delay);
+    state_->callback = std::forward<Func>(f);
+  }
+
+  /// @brief Destructor. Drops a pending call.
+  ~Debouncer()
+  {
+    cancel();
+  }
+
+  Debouncer(const Debouncer &) = delete;
+  Debouncer &operator=(const Debouncer &) = delete;
+
+  /// @brief Records an event; the callback runs once `delay` has passed since the last event
+  void trigger()
+  {
+    state_->last_event.store(clock::now().time_since_epoch().count());  // 热路径: 一次原子写
+    if (!simple_timer::detail::is_armed(state_->armed.load()))
+    {
+      arm();
+    }
+  }
+
+  /// @brief Drops a pending call, if any
+  /// @note A callback that is already running is not interrupted, but no longer re-arms the debouncer.
+  void cancel()
+  {
+    const TimerId id = state_->timer.exchange(0);
+    if (id != 0)
+    {
+      scheduler_.cancel(id);
+    }
+    simple_timer::detail::disarm(state_->armed);
+  }
+
+  /// @brief Checks if a call is pending
+  bool pending() const
+  {
+    return simple_timer::detail::is_armed(state_->armed.load());
+  }
+
+ private:
+  struct State
+  {
+    std::atomic<std::int64_t> last_event{0};  // 最近一次事件的时间 (时钟 tick)
+    std::atomic<std::uint64_t> armed{0};      // 布防字, 见 simple_timer::detail::try_arm
+    std::atomic<TimerId> timer{0};            // 当前定时器 id, 用于取消
+    clock::duration delay{0};
+    std::function<void()> callback;
+  };
+
+  /// @brief 到期处理: 期间有新事件则按剩余时间顺延, 否则执行回调
+  struct Expiry
+  {
+    std::shared_ptr<State> state;
+    std::uint64_t word;  // 布防时的布防字; 不再相等说明已被取消, 不能再修改布防状态
+
+    TimerNext operator()()
+    {
+      if (state->armed.load() != word)
+      {
+        return TimerAction::Stop;
+      }
+      const std::int64_t last = state->last_event.load();
+      const clock::duration remaining = clock::duration(last) + state->delay - clock::now().time_since_epoch();
+      if (remaining > clock::duration::zero())
+      {
+        return remaining;  // 懒惰顺延: 复用同一个定时器节点
+      }
+      state->callback();
+      if (!simple_timer::detail::try_disarm(state->armed, word))
+      {
+        return TimerAction::Stop;  // 回调期间被取消: 布防状态已归 cancel() 及之后的 trigger() 所有
+      }
+      // 与 trigger() 构成 Dekker 式同步: 若在撤防前后有新事件而 trigger() 看到了已布防, 由这里重新布防
+      if (state->last_event.load() != last && simple_timer::detail::try_arm(state->armed, word))
+      {
+        return clock::duration(state->last_event.load()) + state->delay - clock::now().time_since_epoch();
+      }
+      return TimerAction::Stop;
+    }
+  };
+
+  void arm()
+  {
+    std::uint64_t word = state_->armed.load();
+    if (simple_timer::detail::try_arm(state_->armed, word))
+    {
+      state_->timer.store(scheduler_.schedule_after(state_->delay, Expiry{state_, word}));
+    }
+  }
+
+  TimerScheduler &scheduler_;
+  std::shared_ptr<State> state_;  // 与定时器任务共享, 保证任务执行期间状态有效
+};
+
+/// @brief Runs a callback at most once per interval
+class Throttler
+{
+  using clock = TimerScheduler::clock;
+
+ public:
+  /// @brief Constructs a throttler
+  /// @param scheduler The timer engine; must outlive the throttler
+  /// @param interval Minimum time between two calls
+  /// @param f The callback, invoked on the scheduler thread
+  template <typename Rep, typename Period, typename Func>
+  Throttler(TimerScheduler &scheduler, std::chrono::duration<Rep, Period> interval, Func &&f) :
+    scheduler_(scheduler), state_(std::make_shared<State>())
+  {
+    state_->interval = std::chrono::duration_cast<clock::duration>(interval);
+    state_->callback = std::forward<Func>(f);
+  }
+
+  /// @brief Destructor. Drops a pending call.
+  ~Throttler()
+  {
+    cancel();
+  }
+
+  Throttler(const Throttler &) = delete;
+  Throttler &operator=(const Throttler &) = delete;
+
+  /// @brief Records an event; the callback runs now if idle, otherwise once at the end of the current interval
+  void trigger()
+  {
+    state_->pending.store(true);  // 热路径: 一次原子写
+    std::uint64_t word = state_->armed.load();
+    if (!simple_timer::detail::is_armed(word) && simple_timer::detail::try_arm(state_->armed, word))
+    {
+      state_->timer.store(scheduler_.schedule_after(clock::duration::zero(), Tick{state_, word}));
+    }
+  }
+
+  /// @brief Drops a pending call, if any
+  /// @note A callback that is already running is not interrupted, but no longer re-arms the throttler.
+  void cancel()
+  {
+    const TimerId id = state_->timer.exchange(0);
+    if (id != 0)
+    {
+      scheduler_.cancel(id);
+    }
+    state_->pending.store(false);
+    simple_timer::detail::disarm(state_->armed);
+  }
+
+ private:
+  struct State
+  {
+    std::atomic<bool> pending{false};     // 自上次回调后是否有新事件
+    std::atomic<std::uint64_t> armed{0};  // 布防字, 见 simple_timer::detail::try_arm
+    std::atomic<TimerId> timer{0};        // 当前定时器 id, 用于取消
+    clock::duration interval{0};
+    std::function<void()> callback;
+  };
+
+  /// @brief 每个间隔检查一次: 有事件则执行回调并保持定时器, 一个间隔内无事件则撤防
+  struct Tick
+  {
+    std::shared_ptr<State> state;
+    std::uint64_t word;  // 布防时的布防字; 不再相等说明已被取消, 不能再修改布防状态
+
+    TimerNext operator()()
+    {
+      if (state->armed.load() != word)
+      {
+        return TimerAction::Stop;
+      }
+      if (state->pending.exchange(false))
+      {
+        state->callback();
+        return state->interval;  // 继续占用定时器, 合并下一个间隔内的事件; 期间被取消时调度器不会再入队
+      }
+      if (!simple_timer::detail::try_disarm(state->armed, word))
+      {
+        return TimerAction::Stop;
+      }
+      if (state->pending.load() && simple_timer::detail::try_arm(state->armed, word))
+      {
+        return clock::duration::zero();  // 撤防的同时有新事件且距上次回调已满一个间隔: 立即执行
+      }
+      return TimerAction::Stop;
+    }
+  };
+
+  TimerScheduler &scheduler_;
+  std::shared_ptr<State> state_;  // 与定时器任务共享, 保证任务执行期间状态有效
+};
+
+#endif  // SIMPLE_TIMER_DEBOUNCE_H
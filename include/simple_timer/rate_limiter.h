@@ -0,0 +1,142 @@
+/**
+ * @file: rate_limiter.h
+ * @description: Token-bucket rate limiter with lazy refill.
+ *               Tokens are never refilled by a periodic timer: the bucket is a single atomic "theoretical arrival time"
+ *               (GCRA), refills are derived from elapsed `steady_clock` time, and `try_acquire` is a lock-free CAS.
+ *               Waiters are woken by a `TimerScheduler` exactly when enough tokens exist, so thousands of buckets
+ *               cost no threads and no periodic fires.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_RATE_LIMITER_H
+#define SIMPLE_TIMER_RATE_LIMITER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#include "timer_scheduler.h"
+
+/// @brief Token bucket: `rate` tokens per second, holding at most `burst` tokens
+class RateLimiter
+{
+ public:
+  using clock = std::chrono::steady_clock;
+
+  /// @brief Constructs a full bucket
+  /// @param tokens_per_second Refill rate, must be > 0
+  /// @param burst Bucket capacity in tokens, must be >= 1
+  RateLimiter(double tokens_per_second, std::uint32_t burst) :
+    interval_(to_interval(tokens_per_second)),
+    burst_(burst > 0 ? burst : 1),
+    tat_(now_ns())  // 理论到达时间 <= now 表示桶是满的
+  {
+  }
+
+  RateLimiter(const RateLimiter &) = delete;
+  RateLimiter &operator=(const RateLimiter &) = delete;
+
+  /// @brief Takes `n` tokens if they are available right now; lock-free
+  /// @return true if the tokens were taken
+  bool try_acquire(std::uint32_t n = 1)
+  {
+    const std::int64_t now = now_ns();
+    std::int64_t tat = tat_.load(std::memory_order_relaxed);
+    while (true)
+    {
+      const std::int64_t next = (tat > now ? tat : now) + cost(n);
+      if (next - now > capacity())
+      {
+        return false;  // 令牌不足
+      }
+      if (tat_.compare_exchange_weak(tat, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+      {
+        return true;
+      }
+    }
+  }
+
+  /// @brief Reserves `n` tokens unconditionally
+  /// @return How long the caller must wait before using them (zero if available now)
+  clock::duration reserve(std::uint32_t n = 1)
+  {
+    const std::int64_t now = now_ns();
+    std::int64_t tat = tat_.load(std::memory_order_relaxed);
+    std::int64_t next = 0;
+    do
+    {
+      next = (tat > now ? tat : now) + cost(n);
+    } while (!tat_.compare_exchange_weak(tat, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+    const std::int64_t wait = next - capacity() - now;  // 令牌在 next - capacity 时刻才真正可用
+    return std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(wait > 0 ? wait : 0));
+  }
+
+  /// @brief Takes `n` tokens, sleeping the calling thread until they are available
+  void acquire(std::uint32_t n = 1)
+  {
+    const clock::duration wait = reserve(n);
+    if (wait > clock::duration::zero())
+    {
+      std::this_thread::sleep_for(wait);
+    }
+  }
+
+  /// @brief Takes `n` tokens and runs `f` once they are available
+  /// @param scheduler The timer engine used to wake the waiter at the exact time
+  /// @param n Number of tokens
+  /// @param f Callback; runs on the calling thread if the tokens are available now, otherwise on the scheduler thread
+  /// @return The scheduler timer id (can be cancelled, the tokens stay consumed), or 0 if `f` already ran
+  template <typename Func>
+  TimerId acquire_async(TimerScheduler &scheduler, std::uint32_t n, Func &&f)
+  {
+    const clock::duration wait = reserve(n);
+    if (wait <= clock::duration::zero())
+    {
+      f();
+      return 0;
+    }
+    return scheduler.schedule_after(wait, std::forward<Func>(f));
+  }
+
+  /// @brief Gets the number of whole tokens currently available
+  std::uint32_t available() const
+  {
+    const std::int64_t now = now_ns();
+    const std::int64_t tat = tat_.load(std::memory_order_relaxed);
+    const std::int64_t used = tat > now ? tat - now : 0;  // 尚未恢复的令牌所占的时间
+    const std::int64_t free_time = capacity() - used;
+    return free_time > 0 ? static_cast<std::uint32_t>(free_time / interval_) : 0;
+  }
+
+ private:
+  static std::int64_t to_interval(double tokens_per_second)
+  {
+    const double ns = 1e9 / tokens_per_second;
+    return ns >= 1.0 ? static_cast<std::int64_t>(ns) : 1;
+  }
+
+  static std::int64_t now_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+  }
+
+  std::int64_t cost(std::uint32_t n) const
+  {
+    return interval_ * static_cast<std::int64_t>(n);
+  }
+
+  std::int64_t capacity() const
+  {
+    return interval_ * static_cast<std::int64_t>(burst_);
+  }
+
+  const std::int64_t interval_;    // 生成一个令牌所需的纳秒数
+  const std::uint32_t burst_;      // 桶容量
+  std::atomic<std::int64_t> tat_;  // 理论到达时间 (纳秒): 所有已发放令牌都恢复的时刻
+};
+
+#endif  // SIMPLE_TIMER_RATE_LIMITER_H
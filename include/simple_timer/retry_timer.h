@@ -0,0 +1,234 @@
+/**
+ * @file: retry_timer.h
+ * @description: Retry scheduler with exponential backoff and jitter, built on `TimerScheduler`.
+ *               All attempts of one `RetryTimer` reuse the same scheduler node (the task reschedules itself through
+ *               its `TimerNext` result), so retrying never spawns threads. Jitter spreads reconnect storms out.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_RETRY_TIMER_H
+#define SIMPLE_TIMER_RETRY_TIMER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+
+#include "timer_scheduler.h"
+
+/// @brief Backoff configuration of a `RetryTimer`
+/// @note `multiplier` only applies to `Jitter::None` and `Jitter::Full`; `Jitter::Decorrelated` ignores it and grows
+///       by up to 3x the previous delay.
+struct RetryOptions
+{
+  /// @brief Jitter applied to the backoff delay
+  enum class Jitter : unsigned char
+  {
+    None = 0,          // 不加抖动: base * multiplier^n
+    Full = 1,          // 完全抖动: [0, base * multiplier^n] 内均匀分布
+    Decorrelated = 2,  // 去相关抖动: [base, 上一次延迟 * 3] 内均匀分布
+  };
+
+  std::chrono::steady_clock::duration base_delay{std::chrono::milliseconds(100)};  // 第一次重试前的延迟
+  double multiplier{2.0};                                                          // 每次失败后的增长倍数, 小于 1 按 1
+  std::chrono::steady_clock::duration max_delay{std::chrono::seconds(30)};         // 延迟上限
+  Jitter jitter{Jitter::Full};                                                     // 抖动方式
+  std::uint32_t max_attempts{0};                                                   // 最大尝试次数, 0 表示不限
+
+  /// @brief Computes the delay before retry number `retry` (starting at 1)
+  /// @param retry The retry number
+  /// @param previous The previous delay, used by decorrelated jitter
+  /// @param rng Random engine used for jitter
+  template <typename Rng>
+  std::chrono::steady_clock::duration delay(std::uint32_t retry, std::chrono::steady_clock::duration previous,
+                                            Rng &rng) const
+  {
+    using duration = std::chrono::steady_clock::duration;
+    const double cap = static_cast<double>(max_delay.count());
+    const double base = static_cast<double>(base_delay.count());
+    double d = base;
+    if (jitter == Jitter::Decorrelated)
+    {
+      const double hi = std::max(base, static_cast<double>(previous.count()) * 3.0);
+      d = std::uniform_real_distribution<double>(base, hi)(rng);
+    }
+    else
+    {
+      const double exponent = retry > 1 ? static_cast<double>(retry - 1) : 0.0;
+      d *= std::pow(multiplier > 1.0 ? multiplier : 1.0, exponent);  // 闭式计算, 溢出为 inf 时下面取上限
+      if (jitter == Jitter::Full)
+      {
+        d = std::uniform_real_distribution<double>(0.0, std::min(d, cap))(rng);
+      }
+    }
+    return duration(static_cast<duration::rep>(std::min(d, cap)));
+  }
+};
+
+/// @brief Runs an attempt until it succeeds, backing off between failures
+class RetryTimer
+{
+  using clock = TimerScheduler::clock;
+
+ public:
+  /// @brief Constructs a retry timer
+  /// @param scheduler The timer engine; must outlive the retry timer
+  /// @param options Backoff configuration
+  /// @param attempt Callable returning `true` on success; an exception counts as a failure
+  template <typename Func>
+  RetryTimer(TimerScheduler &scheduler, const RetryOptions &options, Func &&attempt) :
+    scheduler_(scheduler), state_(std::make_shared<State>())
+  {
+    state_->options = options;
+    state_->attempt = std::forward<Func>(attempt);
+    state_->rng.seed(std::random_device{}());
+  }
+
+  /// @brief Destructor. Cancels pending retries.
+  ~RetryTimer()
+  {
+    cancel();
+  }
+
+  RetryTimer(const RetryTimer &) = delete;
+  RetryTimer &operator=(const RetryTimer &) = delete;
+
+  /// @brief Sets a callback invoked when `max_attempts` is reached without success
+  template <typename Func>
+  void on_give_up(Func &&f)
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->give_up = std::forward<Func>(f);
+  }
+
+  /// @brief Starts (or restarts) the retry sequence; the first attempt runs right away on the scheduler thread
+  /// @note An attempt of the previous sequence that is still running no longer counts, re-arms or gives up.
+  void start()
+  {
+    cancel_timer();
+    std::uint64_t word = state_->progress.load();
+    while (!state_->progress.compare_exchange_weak(word, ((word >> 32) + 1) << 32))  // 新的代数, 失败次数清零
+    {
+    }
+    Attempt attempt{state_, static_cast<std::uint32_t>((word >> 32) + 1), std::mt19937_64(), clock::duration::zero()};
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      attempt.rng.seed(state_->rng());
+    }
+    state_->timer.store(scheduler_.schedule_after(clock::duration::zero(), std::move(attempt)));
+  }
+
+  /// @brief Cancels pending retries; the attempt counter is kept
+  /// @note A running attempt is not interrupted, but its result is ignored.
+  void cancel()
+  {
+    cancel_timer();
+    state_->progress.fetch_add(kEpochStep);  // 在途的尝试属于旧的代数
+  }
+
+  /// @brief Gets the number of failed attempts since the last start or success
+  std::uint32_t attempts() const
+  {
+    return static_cast<std::uint32_t>(state_->progress.load() & kCountMask);
+  }
+
+ private:
+  static const std::uint64_t kEpochStep = std::uint64_t(1) << 32;
+  static const std::uint64_t kCountMask = kEpochStep - 1;
+
+  struct State
+  {
+    RetryOptions options;
+    std::function<bool()> attempt;
+    std::function<void()> give_up;
+    std::mutex mutex;                        // 保护 give_up 与 rng
+    std::mt19937_64 rng;                     // 为每个序列的尝试生成种子
+    std::atomic<std::uint64_t> progress{0};  // 高 32 位: 序列代数, start/cancel 时加一; 低 32 位: 连续失败次数
+    std::atomic<TimerId> timer{0};           // 当前定时器 id
+  };
+
+  /// @brief 一次尝试: 成功则停止并清零, 失败则返回退避延迟, 复用同一个调度节点
+  /// @note 计数只在代数仍相同时以 CAS 修改; 抖动状态属于这个任务, 执行器模式下新旧序列并发执行也互不影响
+  struct Attempt
+  {
+    std::shared_ptr<State> state;
+    std::uint32_t epoch;       // 所属序列的代数
+    std::mt19937_64 rng;       // 抖动随机数
+    clock::duration previous;  // 上一次延迟 (去相关抖动使用)
+
+    TimerNext operator()()
+    {
+      if (state->progress.load() >> 32 != epoch)
+      {
+        return TimerAction::Stop;  // 已被取消或重新开始
+      }
+      bool ok = false;
+#ifdef SIMPLE_TIMER_NO_EXCEPTIONS
+      ok = state->attempt();
+#else
+      try
+      {
+        ok = state->attempt();
+      }
+      catch (...)
+      {
+        ok = false;  // 异常视为失败
+      }
+#endif
+      std::uint64_t word = state->progress.load();
+      std::uint64_t next = 0;
+      do
+      {
+        if (word >> 32 != epoch)
+        {
+          return TimerAction::Stop;  // 尝试期间被取消或重新开始: 结果不再计入
+        }
+        next = ok ? word & ~kCountMask : word + ((word & kCountMask) == kCountMask ? 0 : 1);
+      } while (!state->progress.compare_exchange_weak(word, next));
+      if (ok)
+      {
+        return TimerAction::Stop;
+      }
+
+      const std::uint32_t failed = static_cast<std::uint32_t>(next & kCountMask);
+      const RetryOptions &opt = state->options;
+      if (opt.max_attempts != 0 && failed >= opt.max_attempts)
+      {
+        std::function<void()> give_up;
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          give_up = state->give_up;
+        }
+        if (give_up)
+        {
+          give_up();
+        }
+        return TimerAction::Stop;
+      }
+      previous = opt.delay(failed, previous, rng);
+      return previous;
+    }
+  };
+
+  void cancel_timer()
+  {
+    const TimerId id = state_->timer.exchange(0);
+    if (id != 0)
+    {
+      scheduler_.cancel(id);
+    }
+  }
+
+  TimerScheduler &scheduler_;
+  std::shared_ptr<State> state_;  // 与定时器任务共享, 保证任务执行期间状态有效
+};
+
+#endif  // SIMPLE_TIMER_RETRY_TIMER_H
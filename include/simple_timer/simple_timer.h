@@ -26,13 +26,102 @@
 #ifndef SIMPLE_TIMER_H
 #define SIMPLE_TIMER_H
 
+/**
+ * 编译期特性开关 (在包含本头文件之前定义):
+ * - SIMPLE_TIMER_NO_EXCEPTIONS:  不捕获任务异常, 去掉错误处理器相关接口; 编译器关闭异常(-fno-exceptions)时自动定义
+ * - SIMPLE_TIMER_NO_DIAGNOSTICS: 不包含 <cstdio>, 任务异常时不输出诊断信息 (默认策略变为静默停止), 去掉超时与耗时统计
+ * - SIMPLE_TIMER_MINIMAL:        同时启用以上两项, 工作线程循环只剩等待与执行任务;
+ *                                状态字在所有配置下都保持原子: pause/resume/stop 总是由其他线程调用, 与工作线程并发
+ *                                读写同一状态, 普通变量会构成数据竞争. 正常触发时工作线程只做原子读取, CAS 只出现在
+ *                                控制接口、暂停停车和停止时
+ * - SIMPLE_TIMER_TRACE:          记录触发/任务/暂停/恢复/间隔修改事件, 可导出为 Chrome trace JSON (见 timer_trace.h);
+ *                                未定义时埋点展开为空, 没有任何开销
+ */
+#ifdef SIMPLE_TIMER_MINIMAL
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+#define SIMPLE_TIMER_NO_EXCEPTIONS
+#endif
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+#define SIMPLE_TIMER_NO_DIAGNOSTICS
+#endif
+#endif
+
+#if !defined(SIMPLE_TIMER_NO_EXCEPTIONS) && !defined(__cpp_exceptions) && !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+#define SIMPLE_TIMER_NO_EXCEPTIONS
+#endif
+
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
-#include <cstdio>
 #include <mutex>
 #include <thread>
+#include <type_traits>
+
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+#include <cmath>
+#include <exception>
+#endif
+
+#if !defined(SIMPLE_TIMER_NO_EXCEPTIONS) || !defined(SIMPLE_TIMER_NO_DIAGNOSTICS)
+#include <functional>
+#endif
+
+#include "timer_math.h"
+
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+#include <cstdio>
+
+#include "timer_metrics.h"
+#endif
+
+#ifdef SIMPLE_TIMER_TRACE
+#include "timer_trace.h"
+#define SIMPLE_TIMER_TRACE_EVENT(event, timer, arg) ::TimerTrace::record(::TraceEvent::event, (timer), (arg))
+#else
+#define SIMPLE_TIMER_TRACE_EVENT(event, timer, arg) ((void)0)
+#endif
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <climits>
+
+namespace simple_timer
+{
+namespace detail
+{
+/// @brief 在 word 仍等于 expected 时睡眠, 直到 CLOCK_MONOTONIC 绝对时间 deadline 或被 futex_wake_all 唤醒
+/// @note FUTEX_WAIT_BITSET 的超时与 clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME) 一样是绝对时间,
+///       但可以被另一个线程唤醒; libstdc++ 的 steady_clock 即 CLOCK_MONOTONIC.
+inline void futex_wait_until(std::atomic<std::uint32_t> *word, std::uint32_t expected,
+                             std::chrono::steady_clock::time_point deadline)
+{
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+  timespec ts;
+  ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+  ts.tv_nsec = static_cast<long>(ns % 1000000000);
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(word), FUTEX_WAIT_BITSET_PRIVATE, expected, &ts, nullptr,
+          FUTEX_BITSET_MATCH_ANY);
+}
+
+/// @brief 在 word 仍等于 expected 时睡眠, 直到被 futex_wake_all 唤醒
+inline void futex_wait(std::atomic<std::uint32_t> *word, std::uint32_t expected)
+{
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+/// @brief 唤醒所有在 word 上睡眠的线程
+inline void futex_wake_all(std::atomic<std::uint32_t> *word)
+{
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+}  // namespace detail
+}  // namespace simple_timer
+#endif
 
 /**
  * @brief 使用 std::condition_variable 的 wait_until 方法 (也可以使用wait_for方法, 但是会累计误差)
@@ -53,10 +142,206 @@
  * - `wait_until` 返回 false 表示已超时, 且条件仍未满足(即超时触发任务)
  */
 
+/// @brief Action requested by a task after it returns
+enum class TimerAction : unsigned char
+{
+  Continue = 0,      // 按当前间隔继续
+  Stop = 1,          // 停止定时器
+  RescheduleIn = 2,  // 在 TimerNext::delay 之后再次触发; 只能由时长构造, 单独返回时按 Continue 处理
+};
+
+/// @brief Value returned by a task to control its next firing
+/// @note Tasks may return `void`, `TimerAction`, any `std::chrono::duration` (same as `RescheduleIn`) or `TimerNext`.
+///       The result is applied by the timer thread itself, no extra locking or wake-up is involved.
+struct TimerNext
+{
+  TimerAction action{TimerAction::Continue};    // 下一步动作
+  std::chrono::steady_clock::duration delay{0};  // 仅 RescheduleIn 使用: 距离下一次触发的时间
+
+  TimerNext() = default;
+
+  /// @brief Implicit conversion from an action, allows `return TimerAction::Stop;`
+  /// @note A bare `RescheduleIn` carries no delay and is treated as `Continue`; return the duration instead.
+  ///       Otherwise it would mean a zero delay and the task would run back-to-back.
+  TimerNext(TimerAction a) :  // NOLINT(google-explicit-constructor)
+    action(a == TimerAction::RescheduleIn ? TimerAction::Continue : a)
+  {
+  }
+
+  /// @brief Implicit conversion from a duration, allows `return std::chrono::milliseconds(50);`
+  template <typename Rep, typename Period>
+  TimerNext(std::chrono::duration<Rep, Period> d) :  // NOLINT(google-explicit-constructor)
+    action(TimerAction::RescheduleIn), delay(std::chrono::duration_cast<std::chrono::steady_clock::duration>(d))
+  {
+  }
+};
+
+/// @brief How a `SimpleTimer` thread sleeps until the next fire
+enum class TimerWaitStrategy : unsigned char
+{
+  ConditionVariable = 0,  // condition_variable::wait_until (默认, 所有平台)
+  AbsoluteSleep = 1,      // Linux: 在 futex 上按 CLOCK_MONOTONIC 绝对时间睡眠; 其他平台等同于 ConditionVariable
+};
+
+/// @brief Timer identifier, unique within the process for `SimpleTimer`
+using TimerId = std::uint64_t;
+
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+/// @brief Information passed to an error handler when a task throws
+struct TimerError
+{
+  std::exception_ptr exception;                     // 任务抛出的异常
+  TimerId timer_id;                                 // 出错的定时器 id
+  std::chrono::steady_clock::time_point fire_time;  // 本次计划触发时间
+  std::uint32_t consecutive;                        // 连续失败次数 (从 1 开始, 成功一次后清零)
+};
+
+/// @brief Error handler, decides how the timer proceeds after a task threw
+/// @note Called on the timer thread without holding the timer's lock. An empty handler is the counter-only fast path:
+///       the error is counted (see `SimpleTimer::errors()`) and the timer continues, no I/O is performed.
+using TimerErrorHandler = std::function<TimerNext(const TimerError &)>;
+
+/// @brief Built-in error policies
+struct TimerErrorPolicy
+{
+  /// @brief Prints the exception to stderr and stops the timer (default behavior)
+  /// @note With `SIMPLE_TIMER_NO_DIAGNOSTICS` nothing is printed, the timer is only stopped.
+  static TimerErrorHandler report_and_stop()
+  {
+#ifdef SIMPLE_TIMER_NO_DIAGNOSTICS
+    return stop();
+#else
+    return [](const TimerError &err) -> TimerNext {
+      try
+      {
+        std::rethrow_exception(err.exception);
+      }
+      catch (const std::exception &e)
+      {
+        std::fprintf(stderr, "\n\033[1;31m[SimpleTimer] Exception: %s\033[0m\n\n", e.what());
+      }
+      catch (...)
+      {
+        std::fprintf(stderr, "\n\033[1;31m[SimpleTimer] Unknown exception occurred.\033[0m\n\n");
+      }
+      return TimerAction::Stop;
+    };
+#endif
+  }
+
+  /// @brief Silently stops the timer
+  static TimerErrorHandler stop()
+  {
+    return [](const TimerError &) -> TimerNext { return TimerAction::Stop; };
+  }
+
+  /// @brief Silently ignores the error and keeps the normal schedule
+  static TimerErrorHandler ignore()
+  {
+    return [](const TimerError &) -> TimerNext { return TimerAction::Continue; };
+  }
+
+  /// @brief Retries after an exponentially growing delay: `base * factor^(consecutive - 1)`, capped at `max_delay`
+  /// @param base Delay after the first failure
+  /// @param max_delay Upper bound of the delay
+  /// @param factor Growth factor between consecutive failures; values below 1 are treated as 1 (constant delay)
+  template <typename Rep1, typename Period1, typename Rep2, typename Period2>
+  static TimerErrorHandler backoff(std::chrono::duration<Rep1, Period1> base,
+                                   std::chrono::duration<Rep2, Period2> max_delay, double factor = 2.0)
+  {
+    using duration = std::chrono::steady_clock::duration;
+    const duration first = std::chrono::duration_cast<duration>(base);
+    const duration cap = std::chrono::duration_cast<duration>(max_delay);
+    const double growth = factor > 1.0 ? factor : 1.0;
+    return [first, cap, growth](const TimerError &err) -> TimerNext {
+      const double exponent = err.consecutive > 1 ? static_cast<double>(err.consecutive - 1) : 0.0;
+      const double delay = static_cast<double>(first.count()) * std::pow(growth, exponent);  // 溢出为 inf 时取上限
+      return delay < static_cast<double>(cap.count()) ? duration(static_cast<duration::rep>(delay)) : cap;
+    };
+  }
+};
+#endif  // SIMPLE_TIMER_NO_EXCEPTIONS
+
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+/// @brief Overrun handler, called when a task ran past the next deadline of its timer
+/// @param lag How far the timer is behind its schedule when the task returned
+/// @param missed_ticks Number of deadlines already due, fired back-to-back next unless the handler changes the timer
+/// @note Called on the timer thread without holding the timer's lock, only for overrunning ticks. It runs inline
+///       after the next deadline has been computed and before the timer waits for it, so it must be cheap: the
+///       schedule keeps its phase, but a slow handler delays the catch-up fires.
+using TimerOverrunHandler = std::function<void(std::chrono::steady_clock::duration lag, std::uint64_t missed_ticks)>;
+#endif
+
+namespace simple_timer
+{
+namespace detail
+{
+/// @brief 生成进程内唯一的定时器 id
+inline TimerId next_timer_id()
+{
+  static std::atomic<TimerId> counter{0};
+  return ++counter;
+}
+
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+/// @brief 调用错误处理器; 处理器本身抛出异常时停止定时器
+inline TimerNext handle_error(const TimerErrorHandler &handler, const TimerError &err)
+{
+  if (!handler)
+  {
+    return TimerAction::Continue;  // 仅计数的快速路径, 不做任何 I/O
+  }
+  try
+  {
+    return handler(err);
+  }
+  catch (...)
+  {
+    return TimerAction::Stop;
+  }
+}
+#endif
+
+/// @brief 任务返回值可转换为 TimerNext: 直接使用其返回值
+template <typename Func>
+inline TimerNext invoke_task(Func &f, std::true_type /*convertible*/)
+{
+  return TimerNext(f());
+}
+
+/// @brief 任务返回 void 或其他无关类型: 忽略返回值, 按原逻辑继续
+template <typename Func>
+inline TimerNext invoke_task(Func &f, std::false_type /*convertible*/)
+{
+  f();
+  return TimerNext();
+}
+
+/// @brief 执行任务并把返回值统一转换为 TimerNext
+template <typename Func>
+inline TimerNext invoke_task(Func &f)
+{
+  return invoke_task(f, std::is_convertible<decltype(f()), TimerNext>());
+}
+
+/// @brief 把任意可调用对象包装为返回 TimerNext 的函数对象 (C++11 无法在 lambda 中移动捕获)
+template <typename Func>
+struct TaskWrapper
+{
+  Func f;
+  TimerNext operator()()
+  {
+    return invoke_task(f);
+  }
+};
+}  // namespace detail
+}  // namespace simple_timer
+
 /// @brief A simple timer class
 class SimpleTimer
 {
-  using clock = std::chrono::steady_clock;  // 单调时钟, 不受系统时间变化影响
+  using clock = std::chrono::steady_clock;       // 单调时钟, 不受系统时间变化影响
+  using wall_clock = std::chrono::system_clock;  // 墙钟, 仅用于计算对齐边界
  public:
   /// @brief Timer state
   enum class State : unsigned char
@@ -73,7 +358,7 @@ class SimpleTimer
   /// @param one_shot If true, the timer will only trigger once
   template <typename Rep, typename Period>
   explicit SimpleTimer(std::chrono::duration<Rep, Period> interval, bool one_shot = false) :
-    interval_(interval), one_shot_(one_shot), state_(State::Stopped)
+    interval_(interval), one_shot_(one_shot), id_(simple_timer::detail::next_timer_id())
   {
   }
 
@@ -108,65 +393,132 @@ class SimpleTimer
   /// @brief Starts the timer
   /// @tparam Func Callable object type
   /// @param f A callable object to be executed when the timer expires
-  /// @note The timer task will be executed in a new thread
+  /// @note The timer task will be executed in a new thread.
+  ///       The task may return a `TimerAction`, a `std::chrono::duration` or a `TimerNext` to decide when it fires
+  ///       next (e.g. adaptive polling); returning `void` keeps the fixed-interval behavior.
   template <typename Func>
   void start(Func &&f)
   {
     stop();                                        // 确保没有其他线程在运行(替换旧任务)
-    state_ = State::Running;                       // 设置状态为运行中
+    set_state(State::Running);                     // 设置状态为运行中
     auto task = std::move(std::forward<Func>(f));  // 完美转发后再 move, 提高效率
     // 使用 std::thread 创建一个新的线程来执行定时器任务
     thread_ = std::thread([this, task]() mutable {
       std::unique_lock<std::mutex> lock(mutex_);
-      auto next_time = clock::now() + interval_;
+      std::int64_t fired_slot = INT64_MIN;  // 墙钟对齐: 上一次已触发的边界序号
+      std::int64_t slot = INT64_MIN;        // 墙钟对齐: 本次等待的边界序号
+      auto next_time = next_deadline(fired_slot, slot);
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+      std::uint32_t failures = 0;  // 连续失败次数
+#endif
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+      clock::time_point started;   // 本次任务开始执行的时间
+      clock::time_point finished;  // 本次任务执行结束的时间
+#endif
       while (true)
       {
-        if (state_ == State::Stopped)
+        if (state() == State::Stopped)
         {
           break;
         }
 
-        while (state_ == State::Paused)
+        if (state() == State::Paused)
         {
-          cv_.wait(lock, [this]() { return state_ != State::Paused; });
-          next_time = clock::now() + interval_;  // 重新计算下一次触发时间
+          park(lock);                                   // 直到 resume 或 stop
+          next_time = next_deadline(fired_slot, slot);  // 重新计算下一次触发时间
+          continue;
         }
 
-        if (cv_.wait_until(lock, next_time, [this]() { return state_ != State::Running || interval_changed_; }))
+        if (wait_until(lock, next_time))
         {
           if (interval_changed_)  // interval_修改后立即使用新间隔
           {
-            next_time = clock::now() + interval_;
+            next_time = next_deadline(fired_slot, slot);
             interval_changed_ = false;
           }
           continue;  // 若状态不是 Running, 继续循环判断; 若是 interval_ 被修改, 则更新 next_time 并立即跳过等待
         }
 
-        lock.unlock();
-        // Timer 内部处理异常, 执行task遇到异常后直接停止timer
-        try
+        if (aligned_ && slot != INT64_MIN)
         {
-          task();  // 执行任务
+          // 等待期间墙钟被回拨, 尚未到达对齐边界: 按墙钟重新计算剩余时间, 不提前触发
+          const auto boundary = clock::duration(slot * interval_.count()) + align_offset_;
+          const auto wall_now = std::chrono::duration_cast<clock::duration>(wall_clock::now().time_since_epoch());
+          if (wall_now < boundary)
+          {
+            next_time = clock::now() + (boundary - wall_now);
+            continue;
+          }
+          fired_slot = slot;
         }
-        catch (const std::exception &e)
+
+        lock.unlock();
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+        started = clock::now();
+#endif
+        SIMPLE_TIMER_TRACE_EVENT(Fire, id_, (clock::now() - next_time).count());
+        SIMPLE_TIMER_TRACE_EVENT(TaskBegin, id_, 0);
+#ifdef SIMPLE_TIMER_NO_EXCEPTIONS
+        TimerNext next = simple_timer::detail::invoke_task(task);  // 执行任务 (不捕获异常)
+#else
+        TimerNext next;            // 任务返回的调度决定
+        std::exception_ptr error;  // Timer 内部捕获异常, 交给错误处理器决定后续行为
+        try
         {
-          state_ = State::Stopped;  // 出现异常时停止定时器 (不能调用stop()会死锁)
-          std::fprintf(stderr, "\n\033[1;31m[SimpleTimer] Exception: %s\033[0m\n\n", e.what());
+          next = simple_timer::detail::invoke_task(task);  // 执行任务
         }
         catch (...)
         {
-          state_ = State::Stopped;  // 出现异常时停止定时器
-          std::fprintf(stderr, "\n\033[1;31m[SimpleTimer] Unknown exception occurred.\033[0m\n\n");
+          error = std::current_exception();
         }
+#endif
+        SIMPLE_TIMER_TRACE_EVENT(TaskEnd, id_, 0);
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+        finished = clock::now();
+        metrics_.record(started - next_time, finished - started);  // 只写原子计数, 不加锁
+#endif
         lock.lock();
 
-        if (one_shot_)
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+        if (error)
         {
-          state_ = State::Stopped;
+          errors_.fetch_add(1, std::memory_order_relaxed);
+          TimerErrorHandler handler = error_handler_;  // 在锁内拷贝, 处理器可能调用本定时器的接口
+          lock.unlock();
+          next = simple_timer::detail::handle_error(handler, TimerError{error, id_, next_time, ++failures});
+          lock.lock();
+        }
+        else
+        {
+          failures = 0;
+        }
+#endif
+
+        if (next.action == TimerAction::Stop || (one_shot_ && next.action == TimerAction::Continue))
+        {
+          set_state(State::Stopped);
           break;
         }
 
-        next_time += interval_;  // 精确推进时间点, 避免偏差
+        if (next.action == TimerAction::RescheduleIn)
+        {
+          next_time = clock::now() + next.delay;  // 由任务决定下一次触发时间 (one-shot 模式下同样生效)
+        }
+        else if (aligned_)
+        {
+          next_time = next_deadline(fired_slot, slot);  // 每次都按墙钟重新对齐, 墙钟跳变后自动同步
+        }
+        else
+        {
+          next_time += interval_;  // 精确推进时间点, 避免偏差
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+          // 先确定下一次触发时间再调用处理器: 处理器耗时只推迟追赶, 不改变相位
+          if (finished - started > interval_ && finished > next_time)  // 任务本身超过一个周期; 追赶中的短任务不计入
+          {
+            overrun(lock, finished - next_time);
+          }
+#endif
+        }
       }
     });
   }
@@ -185,8 +537,8 @@ class SimpleTimer
   /// @note This method may block until the running task completes.
   void stop()
   {
-    state_ = State::Stopped;
-    cv_.notify_all();  // 唤醒等待的线程
+    set_state(State::Stopped);
+    wake();  // 唤醒等待的线程
     if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id())
     {
       thread_.join();  // 等待线程结束, 避免自己 join 自己(死锁)
@@ -194,22 +546,41 @@ class SimpleTimer
   }
 
   /// @brief Pauses the timer
-  void pause()
+  /// @return true if the timer was running; of concurrent control calls exactly one wins each transition
+  /// @note Lock-free. The timer thread is not woken: it sees the state when its pending deadline arrives.
+  bool pause()
   {
-    if (state_ == State::Running)
+    std::uint32_t word = 0;
+    if (!transition(State::Running, State::Paused, word))
     {
-      state_ = State::Paused;
+      return false;
     }
+    SIMPLE_TIMER_TRACE_EVENT(Pause, id_, 0);
+    return true;
   }
 
   /// @brief Resumes the timer if it was paused
-  void resume()
+  /// @return true if the timer was paused
+  /// @note Lock-free. The timer thread is woken only if it already parked; if it is still waiting for the deadline
+  ///       pending when it was paused, that deadline stands: a pause the timer thread never observed does not move
+  ///       its schedule. After a parked pause the next tick comes one interval after the resume, without catching up.
+  bool resume()
   {
-    if (state_ == State::Paused)
+    std::uint32_t word = 0;
+    if (!transition(State::Paused, State::Running, word))
     {
-      state_ = State::Running;
-      cv_.notify_all();  // 唤醒正在等待的线程
+      return false;
     }
+    SIMPLE_TIMER_TRACE_EVENT(Resume, id_, 0);
+    if ((word & kParked) != 0)
+    {
+#if defined(__linux__)
+      simple_timer::detail::futex_wake_all(&ctrl_);  // 停车等待在控制字上, 不需要互斥锁
+#else
+      wake();
+#endif
+    }
+    return true;
   }
 
   /// @brief Gets the current timer interval
@@ -229,7 +600,9 @@ class SimpleTimer
       interval_ = new_interval;
       interval_changed_ = true;  // 标记为已改变
     }
-    cv_.notify_all();  // 确保线程能获取到新的时间间隔
+    SIMPLE_TIMER_TRACE_EVENT(IntervalChange, id_,
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(new_interval).count());
+    wake();  // 确保线程能获取到新的时间间隔
   }
 
   /// @brief Sets a new timer interval, takes effect immediately
@@ -239,40 +612,285 @@ class SimpleTimer
     set_interval(std::chrono::milliseconds(milliseconds));
   }
 
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+  /// @brief Sets the handler invoked when a task throws
+  /// @param handler The error handler, e.g. `TimerErrorPolicy::backoff(...)`; an empty handler only counts errors
+  /// @note The default is `TimerErrorPolicy::report_and_stop()`.
+  void set_error_handler(TimerErrorHandler handler)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_handler_ = std::move(handler);
+  }
+
+  /// @brief Gets the number of exceptions thrown by tasks of this timer
+  std::uint64_t errors() const
+  {
+    return errors_.load(std::memory_order_relaxed);
+  }
+#endif
+
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+  /// @brief Sets the handler invoked when a task overruns its period, see `TimerOverrunHandler`
+  /// @note Only fixed-interval ticks are checked: wall-clock aligned timers skip missed boundaries instead of catching
+  ///       up, and rescheduled ticks have no period. Pass an empty function to remove the handler.
+  /// @note The handler runs inline on the timer thread, after the next deadline has been computed; keep it cheap and
+  ///       hand heavy work to another thread.
+  void on_overrun(TimerOverrunHandler handler)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    overrun_handler_ = std::move(handler);
+  }
+
+  /// @brief Gets the number of ticks whose task ran longer than the interval and past the next deadline
+  std::uint64_t overruns() const
+  {
+    return overruns_.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Gets the sum of the lags reported for all overrunning ticks
+  std::chrono::steady_clock::duration overrun_lag() const
+  {
+    return clock::duration(overrun_lag_.load(std::memory_order_relaxed));
+  }
+
+  /// @brief Gets the fire lateness and execution time histograms, see timer_metrics.h
+  const TimerMetrics &metrics() const
+  {
+    return metrics_;
+  }
+#endif
+
+  /// @brief Gets the process-unique id of this timer
+  TimerId id() const
+  {
+    return id_;
+  }
+
+  /// @brief Aligns fires to wall-clock boundaries: multiples of the interval since the Unix epoch, plus an offset
+  /// @param offset Phase offset added to every boundary, e.g. 5s with a 1-minute interval fires at hh:mm:05
+  /// @note Boundaries are computed from `std::chrono::system_clock`, waiting still uses the steady clock. The schedule
+  ///       is re-synchronized after every fire, and a boundary never fires twice even if the wall clock jumps back.
+  ///       Takes effect immediately if the timer is running.
+  template <typename Rep = std::int64_t, typename Period = std::ratio<1>>
+  void align_to_wall_clock(std::chrono::duration<Rep, Period> offset = std::chrono::duration<Rep, Period>::zero())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      aligned_ = true;
+      align_offset_ = std::chrono::duration_cast<clock::duration>(offset);
+      interval_changed_ = true;  // 复用间隔修改的通知, 让工作线程重新计算触发时间
+    }
+    wake();
+  }
+
+  /// @brief Disables wall-clock alignment, the timer goes back to firing `interval` after start
+  void disable_wall_clock_alignment()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      aligned_ = false;
+      interval_changed_ = true;
+    }
+    wake();
+  }
+
+  /// @brief Selects how the timer thread sleeps until the next fire, takes effect from the next wait
+  /// @param strategy `AbsoluteSleep` sleeps on a futex until an absolute `CLOCK_MONOTONIC` deadline on Linux, with no
+  ///        system-clock conversion; control operations still interrupt it right away.
+  /// @note Both strategies release the timer's mutex for the sleep and take it again on wake-up.
+  void set_wait_strategy(TimerWaitStrategy strategy)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      wait_strategy_ = strategy;
+    }
+    wake();
+  }
+
   /// @brief Gets the current state of the timer
   /// @return The state of the timer
   State state() const
   {
-    return state_;
+    return static_cast<State>(ctrl_.load() & kStateMask);
   }
   /// @brief Checks if the timer is currently running
   /// @return true if running, false otherwise
   bool is_running() const
   {
-    return state_ == State::Running;
+    return state() == State::Running;
   }
   /// @brief Checks if the timer is currently paused
   /// @return true if paused, false otherwise
   bool is_paused() const
   {
-    return state_ == State::Paused;
+    return state() == State::Paused;
   }
   /// @brief Checks if the timer is currently stopped
   /// @return true if stopped, false otherwise
   bool is_stopped() const
   {
-    return state_ == State::Stopped;
+    return state() == State::Stopped;
   }
 
  private:
+  /// @brief 等待到 deadline 或被控制操作唤醒 (需持有 lock)
+  /// @return true 表示状态改变或间隔被修改, 需要重新检查; false 表示已到达 deadline
+  bool wait_until(std::unique_lock<std::mutex> &lock, clock::time_point deadline)
+  {
+    auto woken = [this]() { return state() != State::Running || interval_changed_; };
+#if defined(__linux__)
+    if (wait_strategy_ == TimerWaitStrategy::AbsoluteSleep)
+    {
+      while (true)
+      {
+        const std::uint32_t seq = ctrl_.load();  // 先读控制字再检查条件, 之后的状态修改会让 futex 立即返回
+        if (woken())
+        {
+          return true;
+        }
+        if (clock::now() >= deadline)
+        {
+          return false;
+        }
+        lock.unlock();
+        simple_timer::detail::futex_wait_until(&ctrl_, seq, deadline);
+        lock.lock();
+      }
+    }
+#endif
+    return cv_.wait_until(lock, deadline, woken);
+  }
+
+  /// @brief 唤醒工作线程, 无论它在条件变量上还是在 futex 上等待
+  void wake()
+  {
+    ctrl_.fetch_add(kSeqStep);  // 让即将进入 futex 的等待立即返回
+    {
+      std::lock_guard<std::mutex> lock(mutex_);  // 等待方检查条件与进入等待之间持有锁, 通知不会落在这个窗口里丢失
+    }
+    cv_.notify_all();
+#if defined(__linux__)
+    simple_timer::detail::futex_wake_all(&ctrl_);
+#endif
+  }
+
+  /// @brief 以 CAS 把状态从 from 改为 to, 序号加一并清除停车位
+  /// @param word 输出: 修改前的控制字
+  /// @return false 表示当前状态不是 from, 未修改
+  bool transition(State from, State to, std::uint32_t &word)
+  {
+    word = ctrl_.load();
+    do
+    {
+      if ((word & kStateMask) != static_cast<std::uint32_t>(from))
+      {
+        return false;
+      }
+    } while (!ctrl_.compare_exchange_weak(word, next_word(word, to)));
+    return true;
+  }
+
+  /// @brief 无条件设置状态
+  void set_state(State to)
+  {
+    std::uint32_t word = ctrl_.load();
+    while (!ctrl_.compare_exchange_weak(word, next_word(word, to)))
+    {
+    }
+  }
+
+  static std::uint32_t next_word(std::uint32_t word, State to)
+  {
+    return ((word + kSeqStep) & ~(kStateMask | kParked)) | static_cast<std::uint32_t>(to);
+  }
+
+  /// @brief 暂停期间睡眠, 直到状态离开 Paused (需持有 lock)
+  /// @note 先以 CAS 置上停车位再睡眠: resume() 只在看到此位时才需要唤醒工作线程
+  void park(std::unique_lock<std::mutex> &lock)
+  {
+    std::uint32_t word = ctrl_.load();
+    while ((word & kStateMask) == static_cast<std::uint32_t>(State::Paused))
+    {
+      if ((word & kParked) == 0 && !ctrl_.compare_exchange_weak(word, word | kParked))
+      {
+        continue;  // 控制字刚被修改, 用新值重试
+      }
+      word |= kParked;
+#if defined(__linux__)
+      lock.unlock();
+      simple_timer::detail::futex_wait(&ctrl_, word);  // 控制字已改变时立即返回
+      lock.lock();
+#else
+      cv_.wait(lock, [this, word]() { return ctrl_.load() != word; });
+#endif
+      word = ctrl_.load();
+    }
+  }
+
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+  /// @brief 记录一次超时执行, 有处理器时解锁后调用 (需持有 lock)
+  void overrun(std::unique_lock<std::mutex> &lock, clock::duration lag)
+  {
+    overruns_.fetch_add(1, std::memory_order_relaxed);
+    overrun_lag_.fetch_add(lag.count(), std::memory_order_relaxed);
+    if (!overrun_handler_)
+    {
+      return;
+    }
+    // 已到期的触发点个数, 含 next_time 本身
+    const std::uint64_t missed = interval_.count() > 0 ? static_cast<std::uint64_t>(lag / interval_) + 1 : 1;
+    TimerOverrunHandler handler = overrun_handler_;  // 在锁内拷贝, 处理器可能调用本定时器的接口
+    lock.unlock();
+    handler(lag, missed);
+    lock.lock();
+  }
+#endif
+
+  /// @brief 计算下一次触发时间 (需持有 mutex_)
+  /// @param fired_slot 墙钟对齐模式下上一次已触发的边界序号
+  /// @param slot 输出: 墙钟对齐模式下本次等待的边界序号
+  clock::time_point next_deadline(std::int64_t fired_slot, std::int64_t &slot) const
+  {
+    const auto now = clock::now();
+    if (!aligned_ || interval_.count() <= 0)
+    {
+      slot = INT64_MIN;
+      return now + interval_;
+    }
+    const auto wall_now = std::chrono::duration_cast<clock::duration>(wall_clock::now().time_since_epoch());
+    slot = simple_timer::detail::next_aligned_slot(wall_now.count(), interval_.count(), align_offset_.count(),
+                                                   fired_slot);
+    const auto boundary = clock::duration(slot * interval_.count()) + align_offset_;
+    return now + (boundary - wall_now);
+  }
+
   // 定时器间隔, 默认10秒
   clock::duration interval_{std::chrono::seconds(10)};
-  bool interval_changed_{false};  // 时间间隔是否被修改过
-  bool one_shot_{false};          // 是否只触发一次
-  std::atomic<State> state_;      // 定时器状态
-  std::thread thread_;            // 定时器线程
-  std::mutex mutex_;              // 互斥锁, 确保线程安全
-  std::condition_variable cv_;    // 条件变量, 用于暂停和恢复
+  bool interval_changed_{false};     // 时间间隔是否被修改过
+  bool one_shot_{false};             // 是否只触发一次
+  bool aligned_{false};              // 是否按墙钟边界对齐
+  clock::duration align_offset_{0};  // 墙钟对齐的相位偏移
+  std::thread thread_;               // 定时器线程
+  std::mutex mutex_;                 // 互斥锁, 确保线程安全
+  std::condition_variable cv_;       // 条件变量, 用于暂停和恢复
+
+  TimerId id_;  // 定时器 id
+  TimerWaitStrategy wait_strategy_{TimerWaitStrategy::ConditionVariable};  // 等待方式
+
+  static const std::uint32_t kStateMask = 3;  // 控制字低两位: State
+  static const std::uint32_t kParked = 4;     // 工作线程已在暂停中睡眠, resume() 需要唤醒它
+  static const std::uint32_t kSeqStep = 8;    // 其余位是序号, 每次状态转换或唤醒加一
+  std::atomic<std::uint32_t> ctrl_{0};        // 控制字, 也是 futex 字; 初始为 Stopped
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+  std::atomic<std::uint64_t> errors_{0};                                  // 任务异常次数
+  TimerErrorHandler error_handler_{TimerErrorPolicy::report_and_stop()};  // 任务异常处理器
+#endif
+#ifndef SIMPLE_TIMER_NO_DIAGNOSTICS
+  std::atomic<std::uint64_t> overruns_{0};    // 超时执行次数
+  std::atomic<std::int64_t> overrun_lag_{0};  // 累计落后时间 (clock::duration 的计数)
+  TimerOverrunHandler overrun_handler_;       // 超时执行回调
+  TimerMetrics metrics_;                      // 触发迟到与执行耗时统计
+#endif
 };
 
 #endif  // SIMPLE_TIMER_H
\ No newline at end of file
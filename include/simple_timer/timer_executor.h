@@ -0,0 +1,262 @@
+/**
+ * @file: timer_executor.h
+ * @description: Bounded worker pool for timer callbacks, see `BasicTimerScheduler::set_executor`.
+ *               The queue never grows past its capacity: when it is full, the overflow policy blocks the posting
+ *               (timer) thread, replaces the oldest pending tick of the same timer, drops the new job or runs it
+ *               inline.
+ *
+ * - Jobs are dequeued by priority (FIFO within a priority).
+ * - A job that is dropped, by the overflow policy or because the executor stops, is still called with `run == false`
+ *   so its owner can release what it holds.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_EXECUTOR_H
+#define SIMPLE_TIMER_TIMER_EXECUTOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "simple_timer.h"
+
+/// @brief Dispatch priority of a scheduler timer; higher priorities run first within a batch and in the executor
+enum class TimerPriority : unsigned char
+{
+  Low = 0,       // 可被推迟或丢弃的后台任务, 例如缓存刷新
+  Normal = 1,    // 默认
+  High = 2,      // 例如租约续期
+  Critical = 3,  // 最高
+};
+
+/// @brief What `TimerExecutor::post` does when the queue is full
+enum class ExecutorOverflow : unsigned char
+{
+  Block = 0,       // 阻塞投递线程直到有空位 (默认), 反压传到定时器线程
+  DropOldest = 1,  // 丢弃同一定时器最早的待执行任务; 队列中没有同一定时器的任务时丢弃新任务
+  DropNew = 2,     // 丢弃新任务
+  RunInline = 3,   // 在投递线程上直接执行
+};
+
+/// @brief Counters of a `TimerExecutor`
+struct TimerExecutorStats
+{
+  std::size_t queued{0};      // 当前排队的任务个数
+  std::size_t high_water{0};  // 排队个数的历史最大值
+  std::uint64_t executed{0};  // 工作线程执行的任务个数
+  std::uint64_t dropped{0};   // 被丢弃的任务个数
+  std::uint64_t inlined{0};   // 在投递线程上执行的任务个数
+  std::uint64_t blocked{0};   // 投递时因队列已满而等待的次数
+};
+
+/// @brief Fixed-size worker pool with a bounded, priority-ordered queue
+class TimerExecutor
+{
+ public:
+  /// @brief Job type; `run` is false when the job is dropped instead of executed
+  using Job = std::function<void(bool run)>;
+
+  /// @brief Starts the workers
+  /// @param threads Number of worker threads, at least 1
+  /// @param capacity Maximum number of queued jobs, at least 1
+  /// @param overflow Policy applied when the queue is full
+  TimerExecutor(std::size_t threads, std::size_t capacity, ExecutorOverflow overflow = ExecutorOverflow::Block) :
+    capacity_(capacity == 0 ? 1 : capacity), overflow_(overflow)
+  {
+    for (std::size_t i = 0; i < (threads == 0 ? 1 : threads); ++i)
+    {
+      workers_.emplace_back([this]() { work(); });
+    }
+  }
+
+  /// @brief Destructor. Drops queued jobs and joins the workers.
+  ~TimerExecutor()
+  {
+    stop();
+  }
+
+  TimerExecutor(const TimerExecutor &) = delete;
+  TimerExecutor &operator=(const TimerExecutor &) = delete;
+
+  /// @brief Queues a job, applying the overflow policy if the queue is full
+  /// @param key The timer the job belongs to, used by `ExecutorOverflow::DropOldest`
+  /// @param priority Dequeue priority
+  /// @param job The job; called exactly once, on a worker, inline, or with `run == false` if dropped
+  void post(TimerId key, TimerPriority priority, Job job)
+  {
+    Job discarded;  // 在锁外调用被丢弃的任务
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!stopping_ && queued_ >= capacity_)
+      {
+        switch (overflow_)
+        {
+        case ExecutorOverflow::Block:
+          ++blocked_;
+          not_full_.wait(lock, [this]() { return stopping_ || queued_ < capacity_; });
+          break;
+        case ExecutorOverflow::DropOldest:
+          if (!take_oldest(key, discarded))
+          {
+            discarded = std::move(job);
+          }
+          ++dropped_;
+          break;
+        case ExecutorOverflow::DropNew:
+          discarded = std::move(job);
+          ++dropped_;
+          break;
+        case ExecutorOverflow::RunInline:
+          ++inlined_;
+          lock.unlock();
+          job(true);
+          return;
+        }
+      }
+      if (job && stopping_)
+      {
+        discarded = std::move(job);
+        ++dropped_;
+      }
+      if (job)
+      {
+        queues_[static_cast<std::size_t>(priority)].push_back(Item{key, std::move(job)});
+        ++queued_;
+        high_water_ = queued_ > high_water_ ? queued_ : high_water_;
+        not_empty_.notify_one();
+      }
+    }
+    if (discarded)
+    {
+      discarded(false);
+    }
+  }
+
+  /// @brief Gets the executor counters
+  TimerExecutorStats stats() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TimerExecutorStats s;
+    s.queued = queued_;
+    s.high_water = high_water_;
+    s.executed = executed_;
+    s.dropped = dropped_;
+    s.inlined = inlined_;
+    s.blocked = blocked_;
+    return s;
+  }
+
+  /// @brief Stops the workers after their current job; queued jobs are dropped. Later posts are dropped too.
+  void stop()
+  {
+    std::vector<Item> rest;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      for (std::size_t p = kLevels; p-- > 0;)
+      {
+        for (Item &item : queues_[p])
+        {
+          rest.push_back(std::move(item));
+        }
+        queues_[p].clear();
+      }
+      dropped_ += rest.size();
+      queued_ = 0;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+    for (Item &item : rest)
+    {
+      item.job(false);
+    }
+    for (std::thread &t : workers_)
+    {
+      if (t.joinable() && t.get_id() != std::this_thread::get_id())
+      {
+        t.join();
+      }
+    }
+  }
+
+ private:
+  static const std::size_t kLevels = 4;  // TimerPriority 的级数
+
+  struct Item
+  {
+    TimerId key;
+    Job job;
+  };
+
+  /// @brief 取出同一定时器最早的排队任务 (需持有 mutex_)
+  bool take_oldest(TimerId key, Job &out)
+  {
+    for (std::size_t p = 0; p < kLevels; ++p)
+    {
+      std::deque<Item> &q = queues_[p];
+      for (std::size_t i = 0; i < q.size(); ++i)
+      {
+        if (q[i].key == key)
+        {
+          out = std::move(q[i].job);
+          q.erase(q.begin() + static_cast<std::ptrdiff_t>(i));
+          --queued_;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void work()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+      not_empty_.wait(lock, [this]() { return stopping_ || queued_ != 0; });
+      if (stopping_)
+      {
+        return;
+      }
+      std::size_t p = kLevels - 1;
+      while (queues_[p].empty())
+      {
+        --p;
+      }
+      Job job = std::move(queues_[p].front().job);
+      queues_[p].pop_front();
+      --queued_;
+      ++executed_;
+      not_full_.notify_one();
+      lock.unlock();
+      job(true);
+      job = nullptr;  // 在锁外释放任务持有的资源
+      lock.lock();
+    }
+  }
+
+  mutable std::mutex mutex_;           // 保护以下所有成员
+  std::condition_variable not_empty_;  // 唤醒工作线程
+  std::condition_variable not_full_;   // 唤醒 Block 策略下等待的投递线程
+  std::deque<Item> queues_[kLevels];   // 每个优先级一个 FIFO 队列
+  std::size_t capacity_;               // 排队任务上限
+  ExecutorOverflow overflow_;          // 队列满时的策略
+  std::size_t queued_{0};              // 排队任务个数
+  std::size_t high_water_{0};          // 排队个数的历史最大值
+  std::uint64_t executed_{0};          // 工作线程执行的任务个数
+  std::uint64_t dropped_{0};           // 被丢弃的任务个数
+  std::uint64_t inlined_{0};           // 在投递线程上执行的任务个数
+  std::uint64_t blocked_{0};           // 投递时等待的次数
+  bool stopping_{false};               // 是否已停止
+  std::vector<std::thread> workers_;   // 工作线程, 最后初始化
+};
+
+#endif  // SIMPLE_TIMER_TIMER_EXECUTOR_H
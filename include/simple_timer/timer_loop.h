@@ -0,0 +1,284 @@
+/**
+ * @file: timer_loop.h
+ * @description: Thread-less timers for single-threaded reactors. The timer queue is owned by the caller and driven
+ *               from its own event loop: `timeout_ms()` / `next_deadline()` size the `epoll_wait` timeout, `poll()`
+ *               runs the timers that are due.
+ *
+ * - No threads, no mutexes, no atomics: every member must be called from the thread that owns the loop.
+ * - Tasks may schedule and cancel timers, including their own, from inside `poll()`.
+ * - One-shot and periodic timers; tasks may return `TimerNext` values like with `SimpleTimer`.
+ * - Periodic deadlines advance by exactly one interval per run, so the caller's loop latency does not accumulate.
+ * - Task exceptions go through a `TimerErrorHandler`; a `Stop` result cancels only the failing timer.
+ * - The deadline queue is a template parameter, see timer_queue.h.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_LOOP_H
+#define SIMPLE_TIMER_TIMER_LOOP_H
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "simple_timer.h"
+#include "timer_queue.h"
+
+/// @brief Timers driven by the caller's event loop instead of a thread
+/// @tparam Queue The deadline queue, see timer_queue.h
+/// @tparam Clock The clock source, see timer_clock.h
+template <typename Queue, typename Clock = std::chrono::steady_clock>
+class BasicTimerLoop
+{
+ public:
+  using clock = Clock;
+  using duration = typename Clock::duration;
+  using time_point = typename Clock::time_point;
+
+  BasicTimerLoop() = default;
+
+  BasicTimerLoop(const BasicTimerLoop &) = delete;
+  BasicTimerLoop &operator=(const BasicTimerLoop &) = delete;
+  BasicTimerLoop(BasicTimerLoop &&) = delete;
+  BasicTimerLoop &operator=(BasicTimerLoop &&) = delete;
+
+  /// @brief Schedules a one-shot timer at an absolute time
+  /// @param deadline When the task runs; a deadline in the past runs on the next `poll()`
+  /// @param f A callable object; may return `TimerNext` to be re-armed
+  /// @return The timer id
+  template <typename Func>
+  TimerId schedule_at(time_point deadline, Func &&f)
+  {
+    return add(false, duration::zero(), deadline, std::forward<Func>(f));
+  }
+
+  /// @brief Schedules a one-shot timer
+  /// @param delay Time until the task runs
+  /// @param f A callable object; may return `TimerNext` to be re-armed
+  /// @return The timer id
+  template <typename Rep, typename Period, typename Func>
+  TimerId schedule_after(std::chrono::duration<Rep, Period> delay, Func &&f)
+  {
+    return schedule_at(clock::now() + std::chrono::duration_cast<duration>(delay), std::forward<Func>(f));
+  }
+
+  /// @brief Schedules a periodic timer, the first run happens one interval from now
+  /// @param interval The period
+  /// @param f A callable object; may return `TimerNext` to stop or reschedule itself
+  /// @return The timer id
+  template <typename Rep, typename Period, typename Func>
+  TimerId schedule_every(std::chrono::duration<Rep, Period> interval, Func &&f)
+  {
+    const auto d = std::chrono::duration_cast<duration>(interval);
+    return add(true, d, clock::now() + d, std::forward<Func>(f));
+  }
+
+  /// @brief Cancels a timer
+  /// @return true if the timer existed; a task that is currently running finishes but is not re-armed
+  bool cancel(TimerId id)
+  {
+    auto it = entries_.find(id);
+    if (it == entries_.end() || it->second->cancelled)
+    {
+      return false;
+    }
+    Entry *entry = it->second.get();
+    if (entry->queued())
+    {
+      queue_.erase(entry);
+      entries_.erase(it);
+      return true;
+    }
+    entry->cancelled = true;  // 本轮 poll 已取出 (或正在执行): 轮到它时回收
+    ++cancelled_;
+    return true;
+  }
+
+  /// @brief Gets the number of active timers
+  std::size_t size() const
+  {
+    return entries_.size() - cancelled_;
+  }
+
+  /// @brief Checks if there are no active timers
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  /// @brief Gets the earliest deadline, or `time_point::max()` if there are no timers
+  time_point next_deadline() const
+  {
+    return queue_.empty() ? time_point::max() : time_point(duration(queue_.earliest()));
+  }
+
+  /// @brief Gets the timeout for `epoll_wait` / `poll` in milliseconds until the next deadline
+  /// @return The time left rounded up, so the wait does not end before the deadline; 0 if a timer is due and -1 if
+  ///         there are no timers (wait indefinitely)
+  int timeout_ms(time_point now) const
+  {
+    if (queue_.empty())
+    {
+      return -1;
+    }
+    const duration left = next_deadline() - now;
+    if (left <= duration::zero())
+    {
+      return 0;
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(left);
+    if (ms < left)
+    {
+      ++ms;  // 向上取整
+    }
+    return ms.count() < INT_MAX ? static_cast<int>(ms.count()) : INT_MAX;
+  }
+
+  /// @brief Runs every timer due at `now`, in deadline order
+  /// @param now The current time of the caller's loop; `TimerNext` delays returned by tasks count from it
+  /// @return The next deadline, see `next_deadline()`
+  /// @note Timers that become due while the tasks run (including ones they schedule) wait for the next call, so a
+  ///       call always returns. Calling `poll()` from inside a task does nothing.
+  time_point poll(time_point now)
+  {
+    if (polling_)
+    {
+      return next_deadline();
+    }
+    polling_ = true;
+    batch_.clear();
+    queue_.pop_expired(to_ticks(now), batch_);
+    for (TimerNode *node : batch_)
+    {
+      Entry *entry = static_cast<Entry *>(node);
+      rearm(entry, entry->cancelled ? TimerNext(TimerAction::Stop) : execute(entry, now), now);
+    }
+    polling_ = false;
+    return next_deadline();
+  }
+
+  /// @brief Runs every timer due at `clock::now()`
+  time_point poll()
+  {
+    return poll(clock::now());
+  }
+
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+  /// @brief Sets the handler deciding how a timer proceeds after its task threw
+  /// @note The default is `TimerErrorPolicy::report_and_stop()`. Called from inside `poll()`.
+  void set_error_handler(TimerErrorHandler handler)
+  {
+    error_handler_ = std::move(handler);
+  }
+#endif
+
+ private:
+  /// @brief 定时器条目, 以 TimerNode 作为队列节点
+  struct Entry : TimerNode
+  {
+    bool periodic{false};
+    bool cancelled{false};      // 已被 poll 取出后取消, 轮到它时回收
+    std::uint32_t failures{0};  // 连续失败次数
+    duration interval{0};
+    std::function<TimerNext()> task;
+  };
+
+  static std::int64_t to_ticks(time_point t)
+  {
+    return t.time_since_epoch().count();
+  }
+
+  template <typename Func>
+  TimerId add(bool periodic, duration interval, time_point deadline, Func &&f)
+  {
+    using Task = typename std::decay<Func>::type;
+    std::unique_ptr<Entry> entry(new Entry);
+    entry->id = ++next_id_;
+    entry->deadline = to_ticks(deadline);
+    entry->periodic = periodic;
+    entry->interval = interval;
+    entry->task = simple_timer::detail::TaskWrapper<Task>{std::forward<Func>(f)};
+    queue_.push(entry.get());
+    const TimerId id = entry->id;
+    entries_.emplace(id, std::move(entry));
+    return id;
+  }
+
+  /// @brief 执行一个任务, 异常交给错误处理器
+  TimerNext execute(Entry *entry, time_point now)
+  {
+    (void)now;  // 仅用于追踪
+    SIMPLE_TIMER_TRACE_EVENT(Fire, entry->id, to_ticks(now) - entry->deadline);
+    SIMPLE_TIMER_TRACE_EVENT(TaskBegin, entry->id, 0);
+#ifdef SIMPLE_TIMER_NO_EXCEPTIONS
+    TimerNext next = entry->task();
+    SIMPLE_TIMER_TRACE_EVENT(TaskEnd, entry->id, 0);
+    return next;
+#else
+    std::exception_ptr error;
+    try
+    {
+      TimerNext next = entry->task();
+      SIMPLE_TIMER_TRACE_EVENT(TaskEnd, entry->id, 0);
+      entry->failures = 0;
+      return next;
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+    SIMPLE_TIMER_TRACE_EVENT(TaskEnd, entry->id, 0);
+    const auto fire_time = std::chrono::steady_clock::time_point(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration(entry->deadline)));
+    return simple_timer::detail::handle_error(error_handler_,
+                                              TimerError{error, entry->id, fire_time, ++entry->failures});
+#endif
+  }
+
+  /// @brief 任务执行后根据返回值重新入队或回收
+  void rearm(Entry *entry, const TimerNext &next, time_point now)
+  {
+    bool keep = !entry->cancelled && next.action != TimerAction::Stop;
+    if (keep && next.action == TimerAction::RescheduleIn)
+    {
+      entry->deadline = to_ticks(now + std::chrono::duration_cast<duration>(next.delay));
+    }
+    else if (keep)
+    {
+      keep = entry->periodic;
+      entry->deadline += entry->interval.count();  // 精确推进, 不累计 poll 的延迟
+    }
+    if (keep)
+    {
+      queue_.push(entry);
+      return;
+    }
+    if (entry->cancelled)
+    {
+      --cancelled_;
+    }
+    entries_.erase(entry->id);
+  }
+
+  mutable Queue queue_;                                          // 到期队列; LadderTimerQueue 查询最早到期时会整理桶
+  std::unordered_map<TimerId, std::unique_ptr<Entry>> entries_;  // 所有定时器
+  std::vector<TimerNode *> batch_;                               // 本轮到期的节点, 容量跨轮复用
+  std::size_t cancelled_{0};                                     // 已取消但尚未回收的条目数
+  TimerId next_id_{0};                                           // 上一个分配的 id
+  bool polling_{false};                                          // 正在 poll 中执行任务
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+  TimerErrorHandler error_handler_{TimerErrorPolicy::report_and_stop()};  // 任务异常处理器
+#endif
+};
+
+/// @brief Event-loop timers on a binary heap
+using TimerLoop = BasicTimerLoop<TimerHeap>;
+
+#endif  // SIMPLE_TIMER_TIMER_LOOP_H
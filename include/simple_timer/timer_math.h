@@ -0,0 +1,39 @@
+/**
+ * @file: timer_math.h
+ * @description: Integer helpers shared by `SimpleTimer` wall-clock alignment and `CronExpr`. Kept apart from
+ *               simple_timer.h so headers that only need the arithmetic do not pull in the thread-based timer.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_MATH_H
+#define SIMPLE_TIMER_TIMER_MATH_H
+
+#include <cstdint>
+
+namespace simple_timer
+{
+namespace detail
+{
+/// @brief 向下取整除法 (b > 0)
+inline std::int64_t floor_div(std::int64_t a, std::int64_t b)
+{
+  return a / b - ((a % b != 0) && (a < 0) ? 1 : 0);
+}
+
+/// @brief 墙钟对齐: 计算严格晚于 now 且晚于 last_slot 的下一个边界序号
+/// @param now 当前墙钟时间 (自 epoch 起的 tick 数)
+/// @param interval 周期 (tick 数, > 0)
+/// @param offset 相位偏移 (tick 数)
+/// @param last_slot 上一次已触发的边界序号, 墙钟回拨时保证不会重复触发同一边界
+inline std::int64_t next_aligned_slot(std::int64_t now, std::int64_t interval, std::int64_t offset,
+                                      std::int64_t last_slot)
+{
+  std::int64_t slot = floor_div(now - offset, interval) + 1;
+  return slot > last_slot ? slot : last_slot + 1;
+}
+}  // namespace detail
+}  // namespace simple_timer
+
+#endif  // SIMPLE_TIMER_TIMER_MATH_H
@@ -0,0 +1,123 @@
+/**
+ * @file: timer_metrics.h
+ * @description: Lock-free latency histograms kept by every `SimpleTimer`: fire lateness and task execution time.
+ *               Recording is a few relaxed atomic increments on the timer thread; readers (e.g. `TimerRegistry`
+ *               rendering OpenMetrics text) never lock or allocate.
+ *
+ * - Buckets are powers of two in microseconds: bucket `i` holds samples below `2^i` us, the last one is open-ended
+ *   (about 8.4 s and above).
+ * - Removed with `SIMPLE_TIMER_NO_DIAGNOSTICS`.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_METRICS_H
+#define SIMPLE_TIMER_TIMER_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/// @brief Histogram of durations with power-of-two microsecond buckets
+class TimerHistogram
+{
+ public:
+  static const std::size_t kBuckets = 24;  // 最后一个桶没有上界
+
+  /// @brief Adds a sample; negative durations count as zero
+  void record(std::chrono::nanoseconds d) noexcept
+  {
+    const std::int64_t ns = d.count() > 0 ? d.count() : 0;
+    const std::uint64_t us = static_cast<std::uint64_t>(ns) / 1000;
+    std::size_t i = 0;
+    while (i + 1 < kBuckets && (us >> i) != 0)  // i = us 的有效位数, 即 us < 2^i
+    {
+      ++i;
+    }
+    buckets_[i].fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(static_cast<std::uint64_t>(ns), std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// @brief Gets the number of samples
+  std::uint64_t count() const noexcept
+  {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Gets the sum of all samples
+  std::chrono::nanoseconds sum() const noexcept
+  {
+    return std::chrono::nanoseconds(static_cast<std::int64_t>(sum_ns_.load(std::memory_order_relaxed)));
+  }
+
+  /// @brief Gets the number of samples in bucket `i` (not cumulative)
+  std::uint64_t bucket(std::size_t i) const noexcept
+  {
+    return buckets_[i].load(std::memory_order_relaxed);
+  }
+
+  /// @brief Gets the exclusive upper bound of bucket `i` in seconds; the last bucket has none (+Inf)
+  static double upper_bound(std::size_t i) noexcept
+  {
+    return static_cast<double>(std::uint64_t(1) << i) * 1e-6;
+  }
+
+  /// @brief Estimates a quantile as the upper bound of the bucket holding it
+  /// @param q Quantile in [0, 1]
+  /// @return Seconds; 0 without samples, the last finite bound if the quantile falls in the open-ended bucket
+  double quantile(double q) const noexcept
+  {
+    std::uint64_t counts[kBuckets];
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i)
+    {
+      counts[i] = bucket(i);  // 先取快照, 与写入并发时各桶之和才与 total 一致
+      total += counts[i];
+    }
+    if (total == 0)
+    {
+      return 0.0;
+    }
+    const double rank = q * static_cast<double>(total);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i + 1 < kBuckets; ++i)
+    {
+      seen += counts[i];
+      if (static_cast<double>(seen) >= rank)
+      {
+        return upper_bound(i);
+      }
+    }
+    return upper_bound(kBuckets - 2);
+  }
+
+ private:
+  std::atomic<std::uint64_t> buckets_[kBuckets] = {};
+  std::atomic<std::uint64_t> sum_ns_{0};
+  std::atomic<std::uint64_t> count_{0};
+};
+
+/// @brief Per-timer latency statistics
+struct TimerMetrics
+{
+  TimerHistogram lateness;   // 实际开始执行时间相对计划触发时间的迟到
+  TimerHistogram execution;  // 任务执行耗时
+
+  /// @brief Records one fire
+  void record(std::chrono::nanoseconds late, std::chrono::nanoseconds took) noexcept
+  {
+    lateness.record(late);
+    execution.record(took);
+  }
+
+  /// @brief Gets the number of fires
+  std::uint64_t fires() const noexcept
+  {
+    return execution.count();
+  }
+};
+
+#endif  // SIMPLE_TIMER_TIMER_METRICS_H
@@ -0,0 +1,714 @@
+/**
+ * @file: timer_queue.h
+ * @description: Priority queues of timer nodes used by `TimerScheduler`.
+ *               Nodes are intrusive: the queue only stores pointers and keeps the node's position up to date, so a
+ *               node can be removed or rescheduled without searching.
+ *
+ * - TimerHeap: binary min-heap, O(log n) push/erase, the default.
+ * - FlatTimerQueue: packed deadline array scanned with SIMD, O(1) push/erase; faster for a few thousand timers
+ *   that are mostly rescheduled every tick (see bench/bench_queue.cpp for the crossover).
+ * - LadderTimerQueue: ladder queue with amortized O(1) push/pop/erase, for millions of timers whose deadlines span
+ *   seconds to days.
+ * - A queue provides empty/size/earliest/push/erase/pop_expired/remove_if/clear to be used by `BasicTimerScheduler`.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_QUEUE_H
+#define SIMPLE_TIMER_TIMER_QUEUE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if !defined(SIMPLE_TIMER_NO_SIMD) && (defined(__AVX2__) || defined(__SSE4_2__))
+#include <immintrin.h>
+#endif
+
+#include "simple_timer.h"
+
+/// @brief A node stored in a timer queue
+struct TimerNode
+{
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  std::int64_t deadline{0};  // 到期时间 (时钟 tick, 自时钟 epoch 起)
+  TimerId id{0};             // 定时器 id
+  std::size_t index{npos};   // 在队列中的位置, 由队列维护; npos 表示不在队列中
+  std::size_t bucket{0};     // 所在的桶, 由包含多个容器的队列 (LadderTimerQueue) 维护
+
+  /// @brief Checks if the node is currently in a queue
+  bool queued() const
+  {
+    return index != npos;
+  }
+};
+
+/// @brief Binary min-heap of timer nodes ordered by deadline
+class TimerHeap
+{
+ public:
+  /// @brief Checks if the queue is empty
+  bool empty() const
+  {
+    return heap_.empty();
+  }
+
+  /// @brief Gets the number of queued nodes
+  std::size_t size() const
+  {
+    return heap_.size();
+  }
+
+  /// @brief Gets the earliest deadline, or the maximum value if empty
+  std::int64_t earliest() const
+  {
+    return heap_.empty() ? std::numeric_limits<std::int64_t>::max() : heap_.front()->deadline;
+  }
+
+  /// @brief Gets the node with the earliest deadline, or nullptr if empty
+  TimerNode *top() const
+  {
+    return heap_.empty() ? nullptr : heap_.front();
+  }
+
+  /// @brief Inserts a node that is not queued yet
+  void push(TimerNode *node)
+  {
+    node->index = heap_.size();
+    heap_.push_back(node);
+    sift_up(node->index);
+  }
+
+  /// @brief Removes and returns the node with the earliest deadline, or nullptr if empty
+  TimerNode *pop()
+  {
+    if (heap_.empty())
+    {
+      return nullptr;
+    }
+    TimerNode *node = heap_.front();
+    erase(node);
+    return node;
+  }
+
+  /// @brief Removes all nodes with `deadline <= now` and appends them to `out` in deadline order
+  /// @return The number of nodes removed
+  std::size_t pop_expired(std::int64_t now, std::vector<TimerNode *> &out)
+  {
+    const std::size_t before = out.size();
+    while (!heap_.empty() && heap_.front()->deadline <= now)
+    {
+      out.push_back(pop());
+    }
+    return out.size() - before;
+  }
+
+  /// @brief Removes a queued node
+  void erase(TimerNode *node)
+  {
+    const std::size_t i = node->index;
+    TimerNode *last = heap_.back();
+    heap_.pop_back();
+    node->index = TimerNode::npos;
+    if (last != node)
+    {
+      heap_[i] = last;
+      last->index = i;
+      sift_down(i);
+      sift_up(last->index);
+    }
+  }
+
+  /// @brief Removes every node for which `pred(node)` is true in one O(n) pass
+  /// @return The number of nodes removed
+  template <typename Pred>
+  std::size_t remove_if(Pred pred)
+  {
+    std::size_t kept = 0;
+    for (TimerNode *node : heap_)
+    {
+      if (pred(node))
+      {
+        node->index = TimerNode::npos;
+      }
+      else
+      {
+        place(kept++, node);
+      }
+    }
+    const std::size_t removed = heap_.size() - kept;
+    heap_.resize(kept);
+    for (std::size_t i = kept / 2; i-- > 0;)  // 自底向上重建堆
+    {
+      sift_down(i);
+    }
+    return removed;
+  }
+
+  /// @brief Restores the heap order after the deadline of a queued node was changed
+  void update(TimerNode *node)
+  {
+    sift_down(node->index);
+    sift_up(node->index);
+  }
+
+  /// @brief Removes all nodes
+  void clear()
+  {
+    for (TimerNode *node : heap_)
+    {
+      node->index = TimerNode::npos;
+    }
+    heap_.clear();
+  }
+
+ private:
+  void sift_up(std::size_t i)
+  {
+    TimerNode *node = heap_[i];
+    while (i > 0)
+    {
+      const std::size_t parent = (i - 1) / 2;
+      if (heap_[parent]->deadline <= node->deadline)
+      {
+        break;
+      }
+      place(i, heap_[parent]);
+      i = parent;
+    }
+    place(i, node);
+  }
+
+  void sift_down(std::size_t i)
+  {
+    TimerNode *node = heap_[i];
+    const std::size_t n = heap_.size();
+    while (true)
+    {
+      std::size_t child = 2 * i + 1;
+      if (child >= n)
+      {
+        break;
+      }
+      if (child + 1 < n && heap_[child + 1]->deadline < heap_[child]->deadline)
+      {
+        ++child;
+      }
+      if (node->deadline <= heap_[child]->deadline)
+      {
+        break;
+      }
+      place(i, heap_[child]);
+      i = child;
+    }
+    place(i, node);
+  }
+
+  void place(std::size_t i, TimerNode *node)
+  {
+    heap_[i] = node;
+    node->index = i;
+  }
+
+  std::vector<TimerNode *> heap_;  // 堆数组
+};
+
+namespace simple_timer
+{
+namespace detail
+{
+/// @brief 扫描到期时间数组: 把 deadline <= now 的下标追加到 due, 返回其余元素中的最小到期时间
+/// @note 编译时启用 AVX2 (4 路) 或 SSE4.2 (2 路) 则用比较 + movemask, 否则使用标量循环
+inline std::int64_t scan_deadlines(const std::int64_t *deadlines, std::size_t n, std::int64_t now,
+                                   std::vector<std::size_t> &due)
+{
+  std::int64_t min = std::numeric_limits<std::int64_t>::max();
+  std::size_t i = 0;
+#if !defined(SIMPLE_TIMER_NO_SIMD) && defined(__AVX2__)
+  const __m256i vnow = _mm256_set1_epi64x(now);
+  const __m256i vmax = _mm256_set1_epi64x(min);
+  __m256i vmin = vmax;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(deadlines + i));
+    const __m256i later = _mm256_cmpgt_epi64(v, vnow);  // 未到期的通道
+    unsigned mask = ~static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(later))) & 0xFu;
+    for (std::size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+    {
+      if (mask & 1u)
+      {
+        due.push_back(i + lane);
+      }
+    }
+    const __m256i candidate = _mm256_blendv_epi8(vmax, v, later);
+    vmin = _mm256_blendv_epi8(vmin, candidate, _mm256_cmpgt_epi64(vmin, candidate));
+  }
+  alignas(32) std::int64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), vmin);
+  min = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+#elif !defined(SIMPLE_TIMER_NO_SIMD) && defined(__SSE4_2__)
+  const __m128i vnow = _mm_set1_epi64x(now);
+  const __m128i vmax = _mm_set1_epi64x(min);
+  __m128i vmin = vmax;
+  for (; i + 2 <= n; i += 2)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(deadlines + i));
+    const __m128i later = _mm_cmpgt_epi64(v, vnow);  // 未到期的通道
+    unsigned mask = ~static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(later))) & 0x3u;
+    for (std::size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+    {
+      if (mask & 1u)
+      {
+        due.push_back(i + lane);
+      }
+    }
+    const __m128i candidate = _mm_blendv_epi8(vmax, v, later);
+    vmin = _mm_blendv_epi8(vmin, candidate, _mm_cmpgt_epi64(vmin, candidate));
+  }
+  alignas(16) std::int64_t lanes[2];
+  _mm_store_si128(reinterpret_cast<__m128i *>(lanes), vmin);
+  min = std::min(lanes[0], lanes[1]);
+#endif
+  for (; i < n; ++i)
+  {
+    if (deadlines[i] <= now)
+    {
+      due.push_back(i);
+    }
+    else if (deadlines[i] < min)
+    {
+      min = deadlines[i];
+    }
+  }
+  return min;
+}
+}  // namespace detail
+}  // namespace simple_timer
+
+/// @brief Unordered timer queue: deadlines packed in one array (structure-of-arrays) and scanned linearly
+/// @note Push and erase are O(1); the earliest deadline is cached, so a pass with nothing due costs no scan.
+class FlatTimerQueue
+{
+ public:
+  /// @brief Checks if the queue is empty
+  bool empty() const
+  {
+    return deadlines_.empty();
+  }
+
+  /// @brief Gets the number of queued nodes
+  std::size_t size() const
+  {
+    return deadlines_.size();
+  }
+
+  /// @brief Gets the earliest deadline, or the maximum value if empty
+  std::int64_t earliest() const
+  {
+    if (dirty_)
+    {
+      scratch_.clear();
+      earliest_ = simple_timer::detail::scan_deadlines(deadlines_.data(), deadlines_.size(),
+                                                       std::numeric_limits<std::int64_t>::min(), scratch_);
+      dirty_ = false;
+    }
+    return earliest_;
+  }
+
+  /// @brief Inserts a node that is not queued yet
+  void push(TimerNode *node)
+  {
+    node->index = nodes_.size();
+    nodes_.push_back(node);
+    deadlines_.push_back(node->deadline);
+    if (node->deadline < earliest_)
+    {
+      earliest_ = node->deadline;
+    }
+  }
+
+  /// @brief Removes a queued node
+  void erase(TimerNode *node)
+  {
+    if (node->deadline == earliest_)
+    {
+      dirty_ = true;  // 可能删除了最早的节点, 下次查询时重新扫描
+    }
+    remove_at(node->index);
+  }
+
+  /// @brief Removes all nodes with `deadline <= now` and appends them to `out` in deadline order
+  /// @return The number of nodes removed
+  std::size_t pop_expired(std::int64_t now, std::vector<TimerNode *> &out)
+  {
+    if (earliest() > now)
+    {
+      return 0;  // 常见情况: 没有到期节点, 无需扫描
+    }
+    scratch_.clear();
+    earliest_ = simple_timer::detail::scan_deadlines(deadlines_.data(), deadlines_.size(), now, scratch_);
+    const std::size_t before = out.size();
+    for (std::size_t k = scratch_.size(); k-- > 0;)  // 从后往前删除, 换到前面的尾部元素都已扫描过且未到期
+    {
+      const std::size_t i = scratch_[k];
+      out.push_back(nodes_[i]);
+      remove_at(i);
+    }
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(before), out.end(),
+              [](const TimerNode *a, const TimerNode *b) { return a->deadline < b->deadline; });
+    return out.size() - before;
+  }
+
+  /// @brief Removes every node for which `pred(node)` is true in one O(n) pass
+  /// @return The number of nodes removed
+  template <typename Pred>
+  std::size_t remove_if(Pred pred)
+  {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+    {
+      TimerNode *node = nodes_[i];
+      if (pred(node))
+      {
+        node->index = TimerNode::npos;
+        continue;
+      }
+      node->index = kept;
+      nodes_[kept] = node;
+      deadlines_[kept] = deadlines_[i];
+      ++kept;
+    }
+    const std::size_t removed = nodes_.size() - kept;
+    nodes_.resize(kept);
+    deadlines_.resize(kept);
+    dirty_ = true;
+    return removed;
+  }
+
+  /// @brief Removes all nodes
+  void clear()
+  {
+    for (TimerNode *node : nodes_)
+    {
+      node->index = TimerNode::npos;
+    }
+    nodes_.clear();
+    deadlines_.clear();
+    earliest_ = std::numeric_limits<std::int64_t>::max();
+    dirty_ = false;
+  }
+
+ private:
+  /// @brief 删除下标 i 处的节点: 用尾部元素填补空位
+  void remove_at(std::size_t i)
+  {
+    nodes_[i]->index = TimerNode::npos;
+    const std::size_t last = nodes_.size() - 1;
+    if (i != last)
+    {
+      nodes_[i] = nodes_[last];
+      deadlines_[i] = deadlines_[last];
+      nodes_[i]->index = i;
+    }
+    nodes_.pop_back();
+    deadlines_.pop_back();
+  }
+
+  std::vector<std::int64_t> deadlines_;                                   // 紧凑的到期时间数组, 供 SIMD 扫描
+  std::vector<TimerNode *> nodes_;                                        // 与 deadlines_ 一一对应的节点
+  mutable std::vector<std::size_t> scratch_;                              // 扫描结果缓冲, 容量复用
+  mutable std::int64_t earliest_{std::numeric_limits<std::int64_t>::max()};  // 最早到期时间缓存
+  mutable bool dirty_{false};                                             // 缓存是否失效
+};
+
+/// @brief Ladder queue (Tang, Goh and Thng, 2005): amortized O(1) push, pop and erase
+/// @note Far deadlines wait unsorted in "top". When the near future runs out, top is spread over a rung of buckets
+///       whose width is derived from the deadline range; a crowded bucket spawns a finer rung instead of being sorted,
+///       and only a small bucket (<= kThreshold nodes) is sorted into "bottom", from which nodes are popped.
+///       Bucket widths therefore follow the deadline distribution, and no node is ever cascaded more than kMaxRungs
+///       times.
+class LadderTimerQueue
+{
+ public:
+  LadderTimerQueue() : containers_(2) {}
+
+  /// @brief Checks if the queue is empty
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  /// @brief Gets the number of queued nodes
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  /// @brief Gets the earliest deadline, or the maximum value if empty
+  /// @note Not const: it may move nodes from the upper tiers into bottom.
+  std::int64_t earliest()
+  {
+    refill();
+    return bottom().empty() ? std::numeric_limits<std::int64_t>::max() : bottom().back()->deadline;
+  }
+
+  /// @brief Inserts a node that is not queued yet
+  void push(TimerNode *node)
+  {
+    ++size_;
+    const std::int64_t d = node->deadline;
+    if (d >= top_start_)
+    {
+      append(kTop, node);
+      return;
+    }
+    for (Rung &rung : rungs_)  // 从最粗的梯级往下找覆盖该时间的梯级
+    {
+      if (d >= rung.current_start())
+      {
+        append(rung.first + rung.bucket_of(d), node);
+        return;
+      }
+    }
+    insert_bottom(node);
+    if (bottom().size() > kThreshold && rungs_.size() < kMaxRungs)
+    {
+      std::vector<TimerNode *> nodes;
+      nodes.swap(bottom());
+      spawn(nodes);  // bottom 过大: 拆成新的最细梯级, 保证插入的均摊开销
+    }
+  }
+
+  /// @brief Removes a queued node
+  void erase(TimerNode *node)
+  {
+    --size_;
+    std::vector<TimerNode *> &c = containers_[node->bucket];
+    const std::size_t i = node->index;
+    node->index = TimerNode::npos;
+    if (node->bucket == kBottom)
+    {
+      c.erase(c.begin() + static_cast<std::ptrdiff_t>(i));  // bottom 有序, 保持顺序
+      renumber(kBottom, i);
+      return;
+    }
+    if (i + 1 != c.size())
+    {
+      c[i] = c.back();
+      c[i]->index = i;
+    }
+    c.pop_back();
+  }
+
+  /// @brief Removes all nodes with `deadline <= now` and appends them to `out` in deadline order
+  /// @return The number of nodes removed
+  std::size_t pop_expired(std::int64_t now, std::vector<TimerNode *> &out)
+  {
+    const std::size_t before = out.size();
+    while (earliest() <= now)
+    {
+      TimerNode *node = bottom().back();
+      bottom().pop_back();
+      node->index = TimerNode::npos;
+      --size_;
+      out.push_back(node);
+    }
+    return out.size() - before;
+  }
+
+  /// @brief Removes every node for which `pred(node)` is true in one O(n) pass
+  /// @return The number of nodes removed
+  template <typename Pred>
+  std::size_t remove_if(Pred pred)
+  {
+    std::size_t removed = 0;
+    for (std::size_t c = 0; c < containers_.size(); ++c)
+    {
+      std::vector<TimerNode *> &v = containers_[c];
+      std::size_t kept = 0;
+      for (TimerNode *node : v)
+      {
+        if (pred(node))
+        {
+          node->index = TimerNode::npos;
+          continue;
+        }
+        node->index = kept;
+        v[kept++] = node;  // 保持原有顺序, bottom 仍然有序
+      }
+      removed += v.size() - kept;
+      v.resize(kept);
+    }
+    size_ -= removed;
+    return removed;
+  }
+
+  /// @brief Removes all nodes
+  void clear()
+  {
+    for (std::vector<TimerNode *> &c : containers_)
+    {
+      for (TimerNode *node : c)
+      {
+        node->index = TimerNode::npos;
+      }
+    }
+    containers_.resize(2);
+    top().clear();
+    bottom().clear();
+    rungs_.clear();
+    top_start_ = std::numeric_limits<std::int64_t>::min();
+    size_ = 0;
+  }
+
+ private:
+  static const std::size_t kTop = 0;               // containers_[0]: 远期节点, 无序
+  static const std::size_t kBottom = 1;            // containers_[1]: 近期节点, 按到期时间降序, 从尾部弹出
+  static const std::size_t kThreshold = 50;        // bottom 与单个桶的最大排序规模
+  static const std::size_t kMaxRungs = 8;          // 梯级数上限
+  static const std::size_t kMaxBuckets = 1 << 15;  // 每个梯级的桶数上限
+
+  /// @brief 一级梯子: 覆盖 [start + current * width, ...) 的一组等宽桶, 最后一个桶容纳其后的所有时间
+  struct Rung
+  {
+    std::int64_t start;   // 第一个桶的起始时间
+    std::int64_t width;   // 桶宽
+    std::size_t first;    // 第一个桶在 containers_ 中的下标
+    std::size_t count;    // 桶数
+    std::size_t current;  // 下一个待取出的桶
+
+    std::int64_t current_start() const
+    {
+      return start + static_cast<std::int64_t>(current) * width;
+    }
+
+    std::size_t bucket_of(std::int64_t d) const
+    {
+      const std::size_t b = static_cast<std::size_t>((d - start) / width);
+      return b < count ? b : count - 1;
+    }
+  };
+
+  std::vector<TimerNode *> &top()
+  {
+    return containers_[kTop];
+  }
+
+  std::vector<TimerNode *> &bottom()
+  {
+    return containers_[kBottom];
+  }
+
+  void append(std::size_t c, TimerNode *node)
+  {
+    node->bucket = c;
+    node->index = containers_[c].size();
+    containers_[c].push_back(node);
+  }
+
+  /// @brief 重新编号容器 c 中从 from 开始的节点
+  void renumber(std::size_t c, std::size_t from)
+  {
+    std::vector<TimerNode *> &v = containers_[c];
+    for (std::size_t i = from; i < v.size(); ++i)
+    {
+      v[i]->bucket = c;
+      v[i]->index = i;
+    }
+  }
+
+  void insert_bottom(TimerNode *node)
+  {
+    std::vector<TimerNode *> &b = bottom();
+    auto it = std::upper_bound(b.begin(), b.end(), node,
+                               [](const TimerNode *x, const TimerNode *y) { return x->deadline > y->deadline; });
+    const std::size_t i = static_cast<std::size_t>(it - b.begin());
+    b.insert(it, node);
+    renumber(kBottom, i);
+  }
+
+  /// @brief 把一组节点分散到新的最细梯级上, 桶宽由这组节点的时间范围决定
+  void spawn(std::vector<TimerNode *> &nodes)
+  {
+    std::int64_t lo = std::numeric_limits<std::int64_t>::max();
+    std::int64_t hi = std::numeric_limits<std::int64_t>::min();
+    for (const TimerNode *node : nodes)
+    {
+      lo = std::min(lo, node->deadline);
+      hi = std::max(hi, node->deadline);
+    }
+    Rung rung;
+    rung.count = nodes.size() < kMaxBuckets ? nodes.size() : kMaxBuckets;
+    rung.start = lo;
+    rung.width = (hi - lo) / static_cast<std::int64_t>(rung.count) + 1;
+    rung.first = containers_.size();
+    rung.current = 0;
+    containers_.resize(rung.first + rung.count);
+    for (TimerNode *node : nodes)
+    {
+      append(rung.first + rung.bucket_of(node->deadline), node);
+    }
+    rungs_.push_back(rung);
+  }
+
+  /// @brief bottom 为空时从上层补充, 直到 bottom 非空或队列为空
+  void refill()
+  {
+    while (bottom().empty() && size_ != 0)
+    {
+      if (rungs_.empty())
+      {
+        std::vector<TimerNode *> nodes;
+        nodes.swap(top());
+        spawn(nodes);
+        top_start_ = rungs_.back().start + static_cast<std::int64_t>(rungs_.back().count) * rungs_.back().width;
+        continue;
+      }
+
+      Rung &rung = rungs_.back();
+      while (rung.current < rung.count && containers_[rung.first + rung.current].empty())
+      {
+        ++rung.current;
+      }
+      if (rung.current == rung.count)
+      {
+        containers_.resize(rung.first);  // 梯级已取空
+        rungs_.pop_back();
+        continue;
+      }
+
+      std::vector<TimerNode *> nodes;
+      nodes.swap(containers_[rung.first + rung.current]);
+      ++rung.current;
+      const bool uniform = std::all_of(nodes.begin(), nodes.end(), [&nodes](const TimerNode *node) {
+        return node->deadline == nodes.front()->deadline;
+      });
+      if (nodes.size() > kThreshold && !uniform && rungs_.size() < kMaxRungs)
+      {
+        spawn(nodes);  // 桶太拥挤: 细分而不是排序
+        continue;
+      }
+      std::sort(nodes.begin(), nodes.end(),
+                [](const TimerNode *x, const TimerNode *y) { return x->deadline > y->deadline; });
+      nodes.swap(bottom());
+      renumber(kBottom, 0);
+    }
+    if (size_ == 0)
+    {
+      containers_.resize(2);
+      rungs_.clear();
+      top_start_ = std::numeric_limits<std::int64_t>::min();  // 队列已空, 之后的节点都先进入 top
+    }
+  }
+
+  std::vector<std::vector<TimerNode *>> containers_;                  // top, bottom, 以及各梯级的桶
+  std::vector<Rung> rungs_;                                           // 梯级, 越靠后越细
+  std::int64_t top_start_{std::numeric_limits<std::int64_t>::min()};  // 不小于此时间的节点进入 top
+  std::size_t size_{0};                                               // 节点总数
+};
+
+#endif  // SIMPLE_TIMER_TIMER_QUEUE_H
@@ -0,0 +1,283 @@
+/**
+ * @file: timer_registry.h
+ * @description: Named registry of live `SimpleTimer`s and their OpenMetrics / Prometheus text exposition.
+ *               Scrape timer health without a metrics SDK: render into a caller-provided buffer, or write a
+ *               node_exporter textfile.
+ *
+ * - Rendering reads the timers' atomic counters only: it never takes a timer's lock and never allocates. It holds the
+ *   registry's own lock, which only `add` / `remove` contend for.
+ * - Exposed per timer (label `timer="<name>"`): fires, lateness quantiles (0.5 / 0.9 / 0.99, from the histogram
+ *   buckets), execution time histogram, overruns, exceptions and state.
+ * - The registry keeps plain pointers to the timers: remove a timer before destroying it, e.g. declare the registry
+ *   before the timers so that their owner removes them first. Rendering a destroyed timer is undefined behavior.
+ * - Requires the diagnostics (not available with `SIMPLE_TIMER_NO_DIAGNOSTICS`).
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_REGISTRY_H
+#define SIMPLE_TIMER_TIMER_REGISTRY_H
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "simple_timer.h"
+
+#ifdef SIMPLE_TIMER_NO_DIAGNOSTICS
+#error "timer_registry.h requires the timer diagnostics, do not define SIMPLE_TIMER_NO_DIAGNOSTICS"
+#endif
+
+/// @brief Text exposition format
+enum class MetricsFormat : unsigned char
+{
+  OpenMetrics = 0,  // application/openmetrics-text; version=1.0.0
+  Prometheus = 1,   // text/plain; version=0.0.4, 供 node_exporter textfile collector 读取
+};
+
+/// @brief Registry of named timers
+/// @note Timers must be removed before they are destroyed: the registry does not own them and `SimpleTimer` does not
+///       know about registries, so a destroyed timer left registered is read through a dangling pointer.
+class TimerRegistry
+{
+ public:
+  /// @brief Registers a timer under a name
+  /// @param name Value of the `timer` label; quotes, backslashes and newlines are escaped
+  /// @param timer The timer; must stay alive until removed
+  /// @return false if the timer or the name is already registered
+  bool add(const std::string &name, const SimpleTimer &timer)
+  {
+    const std::string label = escape(name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Item &item : items_)
+    {
+      if (item.timer == &timer || item.label == label)
+      {
+        return false;
+      }
+    }
+    items_.push_back(Item{label, &timer});
+    return true;
+  }
+
+  /// @brief Unregisters a timer
+  /// @return false if it was not registered
+  bool remove(const SimpleTimer &timer)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::size_t i = 0; i < items_.size(); ++i)
+    {
+      if (items_[i].timer == &timer)
+      {
+        items_.erase(items_.begin() + static_cast<std::ptrdiff_t>(i));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// @brief Gets the number of registered timers
+  std::size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+  }
+
+  /// @brief Renders all registered timers as exposition text
+  /// @param buf Output buffer, always NUL-terminated when `size > 0`; may be null when `size == 0`
+  /// @param size Size of the buffer
+  /// @param format OpenMetrics (ends with `# EOF`) or the Prometheus text format
+  /// @return The length of the full text; it was truncated if the result is `>= size`, like `snprintf`
+  std::size_t render(char *buf, std::size_t size, MetricsFormat format = MetricsFormat::OpenMetrics) const
+  {
+    Writer w{buf, size, 0};
+    const bool om = format == MetricsFormat::OpenMetrics;
+    const char *total = om ? "" : "_total";  // Prometheus 文本格式的 TYPE 行使用完整的样本名
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    w.put("# TYPE simple_timer_fires%s counter\n# HELP simple_timer_fires%s Number of task runs.\n", total, total);
+    for (const Item &item : items_)
+    {
+      w.put("simple_timer_fires_total{timer=\"%s\"} %llu\n", item.label.c_str(),
+            static_cast<unsigned long long>(item.timer->metrics().fires()));
+    }
+
+    w.put("# TYPE simple_timer_lateness_seconds summary\n"
+          "# HELP simple_timer_lateness_seconds Delay between the scheduled and the actual start of a task.\n");
+    for (const Item &item : items_)
+    {
+      const TimerHistogram &h = item.timer->metrics().lateness;
+      static const double kQuantiles[] = {0.5, 0.9, 0.99};
+      for (double q : kQuantiles)
+      {
+        w.put("simple_timer_lateness_seconds{timer=\"%s\",quantile=\"%g\"} %.9g\n", item.label.c_str(), q,
+              h.quantile(q));
+      }
+      std::uint64_t samples = 0;
+      for (std::size_t i = 0; i < TimerHistogram::kBuckets; ++i)
+      {
+        samples += h.bucket(i);
+      }
+      put_sum_count(w, "simple_timer_lateness_seconds", item.label.c_str(), h, samples);
+    }
+
+    w.put("# TYPE simple_timer_execution_seconds histogram\n"
+          "# HELP simple_timer_execution_seconds Task execution time.\n");
+    for (const Item &item : items_)
+    {
+      const TimerHistogram &h = item.timer->metrics().execution;
+      std::uint64_t cumulative = 0;
+      for (std::size_t i = 0; i + 1 < TimerHistogram::kBuckets; ++i)
+      {
+        cumulative += h.bucket(i);
+        w.put("simple_timer_execution_seconds_bucket{timer=\"%s\",le=\"%g\"} %llu\n", item.label.c_str(),
+              TimerHistogram::upper_bound(i), static_cast<unsigned long long>(cumulative));
+      }
+      cumulative += h.bucket(TimerHistogram::kBuckets - 1);
+      w.put("simple_timer_execution_seconds_bucket{timer=\"%s\",le=\"+Inf\"} %llu\n", item.label.c_str(),
+            static_cast<unsigned long long>(cumulative));
+      put_sum_count(w, "simple_timer_execution_seconds", item.label.c_str(), h, cumulative);
+    }
+
+    w.put("# TYPE simple_timer_overruns%s counter\n"
+          "# HELP simple_timer_overruns%s Number of ticks whose task ran longer than the interval.\n",
+          total, total);
+    for (const Item &item : items_)
+    {
+      w.put("simple_timer_overruns_total{timer=\"%s\"} %llu\n", item.label.c_str(),
+            static_cast<unsigned long long>(item.timer->overruns()));
+    }
+
+    w.put("# TYPE simple_timer_exceptions%s counter\n# HELP simple_timer_exceptions%s Number of tasks that threw.\n",
+          total, total);
+    for (const Item &item : items_)
+    {
+      w.put("simple_timer_exceptions_total{timer=\"%s\"} %llu\n", item.label.c_str(),
+            static_cast<unsigned long long>(errors(*item.timer)));
+    }
+
+    w.put("# TYPE simple_timer_state %s\n# HELP simple_timer_state Current timer state.\n",
+          om ? "stateset" : "gauge");
+    for (const Item &item : items_)
+    {
+      const SimpleTimer::State state = item.timer->state();
+      static const char *const kNames[] = {"stopped", "running", "paused"};
+      for (int s = 0; s < 3; ++s)
+      {
+        w.put("simple_timer_state{timer=\"%s\",simple_timer_state=\"%s\"} %d\n", item.label.c_str(), kNames[s],
+              static_cast<int>(state) == s ? 1 : 0);
+      }
+    }
+
+    if (om)
+    {
+      w.put("# EOF\n");
+    }
+    return w.len;
+  }
+
+  /// @brief Writes the Prometheus text format for the node_exporter textfile collector
+  /// @param path Target file, e.g. `/var/lib/node_exporter/textfile/app_timers.prom`; written to `path.tmp` first
+  ///        and renamed, so the collector never reads a partial file
+  /// @return true on success
+  bool write_textfile(const std::string &path) const
+  {
+    std::vector<char> text(render(nullptr, 0, MetricsFormat::Prometheus) + 256);  // 余量: 两次渲染之间可能新增数据
+    std::size_t len = render(text.data(), text.size(), MetricsFormat::Prometheus);
+    while (len >= text.size())
+    {
+      text.resize(len + 256);
+      len = render(text.data(), text.size(), MetricsFormat::Prometheus);
+    }
+    const std::string tmp = path + ".tmp";
+    std::FILE *f = std::fopen(tmp.c_str(), "wb");
+    if (f == nullptr)
+    {
+      return false;
+    }
+    const bool written = std::fwrite(text.data(), 1, len, f) == len;
+    if (std::fclose(f) != 0 || !written || std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+      std::remove(tmp.c_str());
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  struct Item
+  {
+    std::string label;         // 已转义的名称
+    const SimpleTimer *timer;  // 注册的定时器
+  };
+
+  /// @brief 按 snprintf 语义追加到调用方的缓冲区, 超出时只累计长度
+  struct Writer
+  {
+    char *buf;
+    std::size_t size;
+    std::size_t len;
+
+    void put(const char *fmt, ...)
+    {
+      va_list args;
+      va_start(args, fmt);
+      const int n = std::vsnprintf(len < size ? buf + len : nullptr, len < size ? size - len : 0, fmt, args);
+      va_end(args);
+      if (n > 0)
+      {
+        len += static_cast<std::size_t>(n);
+      }
+    }
+  };
+
+  /// @param count 渲染出的各桶之和; 不单独读取 h.count(), 与写入并发时 _count 才与 +Inf 桶一致
+  static void put_sum_count(Writer &w, const char *name, const char *label, const TimerHistogram &h,
+                            std::uint64_t count)
+  {
+    w.put("%s_sum{timer=\"%s\"} %.9g\n%s_count{timer=\"%s\"} %llu\n", name, label,
+          static_cast<double>(h.sum().count()) * 1e-9, name, label, static_cast<unsigned long long>(count));
+  }
+
+  static std::uint64_t errors(const SimpleTimer &timer)
+  {
+#ifdef SIMPLE_TIMER_NO_EXCEPTIONS
+    (void)timer;
+    return 0;
+#else
+    return timer.errors();
+#endif
+  }
+
+  /// @brief 转义标签值中的反斜杠、双引号和换行
+  static std::string escape(const std::string &name)
+  {
+    std::string out;
+    for (char c : name)
+    {
+      if (c == '\\' || c == '"')
+      {
+        out += '\\';
+        out += c;
+      }
+      else if (c == '\n')
+      {
+        out += "\\n";
+      }
+      else
+      {
+        out += c;
+      }
+    }
+    return out;
+  }
+
+  mutable std::mutex mutex_;  // 保护 items_, 只与 add/remove 互斥
+  std::vector<Item> items_;   // 注册的定时器
+};
+
+#endif  // SIMPLE_TIMER_TIMER_REGISTRY_H
@@ -0,0 +1,1113 @@
+/**
+ * @file: timer_scheduler.h
+ * @description: A shared timer engine: many timers served by one dispatch thread and one deadline queue.
+ *               Each timer costs a queue node instead of a thread, which suits large numbers of timers
+ *               (periodic jobs, cron entries, timeouts, ...).
+ *
+ * - Features:
+ *    - One-shot, periodic and cron timers; tasks may return `TimerNext` values like with `SimpleTimer`.
+ *    - O(log n) schedule/cancel, cancelling from any thread (including from inside the task) is safe.
+ *    - Optional lazy cancellation: cancelled timers stay in the queue as tombstones, are skipped when they expire and
+ *      are compacted in one pass once they exceed a share of the queue.
+ *    - Task exceptions go through a `TimerErrorHandler`; a `Stop` result cancels only the failing timer.
+ *    - Timers due at the same time are popped under one lock and run as a batch; `on_expired` sees the batch ids.
+ *    - The clock is a template parameter too, see timer_clock.h (coarse, TSC and cached-now sources).
+ *    - The deadline queue is a template parameter: `TimerScheduler` uses a `TimerHeap`, `FlatTimerScheduler` a
+ *      `FlatTimerQueue` and `LadderTimerScheduler` a `LadderTimerQueue`.
+ *    - Tasks run on the dispatch thread, keep them short.
+ *    - Timers can be paused and resumed one by one; `snapshot()` / `restore()` carry their phase across restarts.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_SCHEDULER_H
+#define SIMPLE_TIMER_TIMER_SCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cron_expr.h"
+#include "simple_timer.h"
+#include "timer_clock.h"
+#include "timer_executor.h"
+#include "timer_queue.h"
+#include "timer_snapshot.h"
+
+/// @brief A read-only view of the timer ids expired in one batch
+struct TimerIdSpan
+{
+  const TimerId *data;
+  std::size_t size;
+
+  const TimerId *begin() const
+  {
+    return data;
+  }
+  const TimerId *end() const
+  {
+    return data + size;
+  }
+  TimerId operator[](std::size_t i) const
+  {
+    return data[i];
+  }
+};
+
+/// @brief Callback receiving all timer ids that expired in the same dispatch pass
+using TimerBatchHandler = std::function<void(TimerIdSpan)>;
+
+/// @brief How `cancel()` removes a timer from the deadline queue
+enum class TimerCancelMode : unsigned char
+{
+  Eager = 0,  // 立即从队列中删除 (默认), 每次取消一次堆调整
+  Lazy = 1,   // 只标记为墓碑, 到期时跳过, 墓碑过多时整体压缩
+};
+
+/// @brief What the scheduler does with low-priority timers when it falls behind
+struct TimerOverloadPolicy
+{
+  /// @brief Action applied to a shed timer
+  enum class Action : unsigned char
+  {
+    None = 0,   // 不降级, 全部按时执行 (默认)
+    Delay = 1,  // 本次不执行: 单次/cron 定时器重新入队到当前时刻, 排在下一批的高优先级任务之后;
+                //   周期定时器按整周期顺延, 保持原有相位
+    Drop = 2,   // 跳过本次: 周期/cron 定时器等待下一个周期, 单次定时器被删除
+  };
+
+  Action action{Action::None};
+  std::chrono::nanoseconds max_lag{std::chrono::milliseconds(10)};  // 任务开始时落后计划超过此值视为过载
+  TimerPriority protect{TimerPriority::High};                        // 不低于此优先级的定时器从不降级
+};
+
+/// @brief Counters of a `BasicTimerScheduler`
+struct TimerSchedulerStats
+{
+  std::size_t timers{0};                // 存活的定时器个数
+  std::size_t tombstones{0};            // 队列中已取消但尚未清除的节点个数
+  std::uint64_t compactions{0};         // 压缩次数
+  std::uint64_t tombstones_skipped{0};  // 到期时被跳过的墓碑个数
+  std::uint64_t delayed{0};             // 过载时被推迟的次数
+  std::uint64_t dropped{0};             // 过载时被丢弃的次数
+  std::uint64_t skipped{0};             // 单飞定时器上一次尚未执行完而跳过的次数
+};
+
+/// @brief Result of `BasicTimerScheduler::restore`
+struct TimerRestoreStats
+{
+  std::size_t resumed{0};    // 按快照恢复了相位与暂停状态的定时器个数
+  std::size_t fresh{0};      // 快照中没有记录, 像 schedule_* 一样重新开始的定时器个数
+  std::size_t conflicts{0};  // id 已被占用而跳过的定时器个数
+};
+
+/// @brief Timers to restore and their tasks, under ids chosen by the caller that stay stable across restarts
+/// @note See `BasicTimerScheduler::restore`.
+class TimerBindings
+{
+ public:
+  /// @brief A bound timer
+  struct Binding
+  {
+    TimerId id;
+    TimerKind kind;
+    std::chrono::nanoseconds interval;  // 周期, 或单次定时器的延迟
+    CronExpr cron;
+    std::chrono::minutes utc_offset;
+    TimerPriority priority;
+    std::function<TimerNext()> task;
+  };
+
+  /// @brief Binds a one-shot timer, see `BasicTimerScheduler::schedule_after`
+  /// @return false if the id is 0 or already bound
+  template <typename Rep, typename Period, typename Func>
+  bool after(TimerId id, std::chrono::duration<Rep, Period> delay, Func &&f,
+             TimerPriority priority = TimerPriority::Normal)
+  {
+    return bind(id, TimerKind::Once, std::chrono::duration_cast<std::chrono::nanoseconds>(delay), CronExpr(),
+                std::chrono::minutes(0), priority, std::forward<Func>(f));
+  }
+
+  /// @brief Binds a periodic timer, see `BasicTimerScheduler::schedule_every`
+  /// @return false if the id is 0 or already bound
+  template <typename Rep, typename Period, typename Func>
+  bool every(TimerId id, std::chrono::duration<Rep, Period> interval, Func &&f,
+             TimerPriority priority = TimerPriority::Normal)
+  {
+    return bind(id, TimerKind::Periodic, std::chrono::duration_cast<std::chrono::nanoseconds>(interval), CronExpr(),
+                std::chrono::minutes(0), priority, std::forward<Func>(f));
+  }
+
+  /// @brief Binds a cron timer, see `BasicTimerScheduler::schedule_cron`
+  /// @return false if the id is 0 or already bound, or the expression is invalid
+  template <typename Func>
+  bool cron(TimerId id, const CronExpr &expr, Func &&f, std::chrono::minutes utc_offset = std::chrono::minutes(0),
+            TimerPriority priority = TimerPriority::Normal)
+  {
+    return expr.valid() && bind(id, TimerKind::Cron, std::chrono::nanoseconds(0), expr, utc_offset, priority,
+                                std::forward<Func>(f));
+  }
+
+  /// @brief Gets the bound timers in binding order
+  const std::vector<Binding> &items() const
+  {
+    return items_;
+  }
+
+ private:
+  template <typename Func>
+  bool bind(TimerId id, TimerKind kind, std::chrono::nanoseconds interval, const CronExpr &expr,
+            std::chrono::minutes utc_offset, TimerPriority priority, Func &&f)
+  {
+    using Task = typename std::decay<Func>::type;
+    if (id == 0)
+    {
+      return false;
+    }
+    for (const Binding &b : items_)
+    {
+      if (b.id == id)
+      {
+        return false;
+      }
+    }
+    items_.push_back(Binding{id, kind, interval, expr, utc_offset, priority,
+                             simple_timer::detail::TaskWrapper<Task>{std::forward<Func>(f)}});
+    return true;
+  }
+
+  std::vector<Binding> items_;  // 按绑定顺序
+};
+
+/// @brief A timer engine serving many timers from one thread
+/// @tparam Queue The deadline queue, see timer_queue.h
+/// @tparam Clock The clock source, see timer_clock.h; its duration must be `std::chrono::nanoseconds`
+template <typename Queue, typename Clock = std::chrono::steady_clock>
+class BasicTimerScheduler
+{
+ public:
+  using clock = Clock;
+
+  /// @brief Constructs the scheduler and starts its dispatch thread
+  BasicTimerScheduler() : thread_([this]() { run(); }) {}
+
+  /// @brief Destructor. Stops the dispatch thread and drops all timers.
+  ~BasicTimerScheduler()
+  {
+    stop();
+  }
+
+  BasicTimerScheduler(const BasicTimerScheduler &) = delete;
+  BasicTimerScheduler &operator=(const BasicTimerScheduler &) = delete;
+  BasicTimerScheduler(BasicTimerScheduler &&) = delete;
+  BasicTimerScheduler &operator=(BasicTimerScheduler &&) = delete;
+
+  /// @brief Schedules a one-shot timer
+  /// @param delay Time until the task runs
+  /// @param f A callable object; may return `TimerNext` to be re-armed
+  /// @param priority Dispatch priority within an expiry batch
+  /// @return The timer id, or 0 if the scheduler is stopped
+  template <typename Rep, typename Period, typename Func>
+  TimerId schedule_after(std::chrono::duration<Rep, Period> delay, Func &&f,
+                         TimerPriority priority = TimerPriority::Normal)
+  {
+    const auto d = std::chrono::duration_cast<duration>(delay);
+    return add(make_entry(Kind::Once, d, priority, std::forward<Func>(f)), fresh_now() + d);
+  }
+
+  /// @brief Schedules a periodic timer, the first run happens one interval from now
+  /// @param interval The period
+  /// @param f A callable object; may return `TimerNext` to stop or reschedule itself
+  /// @param priority Dispatch priority within an expiry batch
+  /// @return The timer id, or 0 if the scheduler is stopped
+  template <typename Rep, typename Period, typename Func>
+  TimerId schedule_every(std::chrono::duration<Rep, Period> interval, Func &&f,
+                         TimerPriority priority = TimerPriority::Normal)
+  {
+    const auto d = std::chrono::duration_cast<duration>(interval);
+    return add(make_entry(Kind::Periodic, d, priority, std::forward<Func>(f)), fresh_now() + d);
+  }
+
+  /// @brief Schedules a cron timer
+  /// @param expr A valid cron expression; only the next deadline is kept in the queue
+  /// @param f A callable object; returning `TimerAction::Stop` cancels the timer
+  /// @param utc_offset Fixed offset from UTC used to evaluate the expression
+  /// @param priority Dispatch priority within an expiry batch
+  /// @return The timer id, or 0 if the expression is invalid or the scheduler is stopped
+  template <typename Func>
+  TimerId schedule_cron(const CronExpr &expr, Func &&f, std::chrono::minutes utc_offset = std::chrono::minutes(0),
+                        TimerPriority priority = TimerPriority::Normal)
+  {
+    if (!expr.valid())
+    {
+      return 0;
+    }
+    std::unique_ptr<Entry> entry = make_entry(Kind::Cron, duration::zero(), priority, std::forward<Func>(f));
+    entry->cron = expr;
+    entry->utc_offset = utc_offset;
+    const time_point deadline = cron_deadline(*entry);
+    if (deadline == time_point::max())
+    {
+      return 0;  // 表达式永远不会触发, 例如 2 月 30 日
+    }
+    return add(std::move(entry), deadline);
+  }
+
+  /// @brief Cancels a timer
+  /// @return true if the timer existed; a task that is currently running finishes but is not re-armed
+  bool cancel(TimerId id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end() || it->second->cancelled)
+    {
+      return false;
+    }
+    Entry *entry = it->second.get();
+    if (entry->running != 0)
+    {
+      entry->cancelled = true;  // 正在执行: 在最后一次执行结束后回收
+      ++cancelled_;
+      if (entry->queued())
+      {
+        queue_.erase(entry);  // 执行器模式下周期定时器在派发时已重新入队
+      }
+      return true;
+    }
+    if (entry->paused)
+    {
+      entries_.erase(it);  // 暂停中: 不在队列中
+      return true;
+    }
+    if (cancel_mode_ == TimerCancelMode::Lazy)
+    {
+      entry->cancelled = true;  // 墓碑: 留在队列中, 到期时或压缩时回收
+      entry->task = nullptr;    // 与立即删除一样, 在取消时释放任务持有的资源
+      ++tombstones_;
+      ++cancelled_;
+      if (tombstones_ >= kMinCompaction && static_cast<double>(tombstones_) > compact_ratio_ * queue_.size())
+      {
+        compact();
+      }
+      return true;
+    }
+    queue_.erase(entry);
+    entries_.erase(it);
+    return true;
+  }
+
+  /// @brief Pauses a timer; it keeps the time left until its next deadline and does not fire until resumed
+  /// @return false if the timer does not exist or is already paused; a task that is currently running finishes
+  bool pause(TimerId id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end() || it->second->cancelled || it->second->paused)
+    {
+      return false;
+    }
+    Entry *entry = it->second.get();
+    entry->paused = true;
+    if (entry->queued())
+    {
+      queue_.erase(entry);
+      park(entry);
+    }
+    return true;  // 不在队列中说明正在执行, 结束时再记下剩余时间
+  }
+
+  /// @brief Resumes a paused timer with the time it had left; a cron timer resumes at its next match
+  /// @return false if the timer does not exist or is not paused
+  bool resume(TimerId id)
+  {
+    bool earliest = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = entries_.find(id);
+      if (it == entries_.end() || it->second->cancelled || !it->second->paused)
+      {
+        return false;
+      }
+      Entry *entry = it->second.get();
+      entry->paused = false;
+      if (!entry->parked)
+      {
+        return true;  // 正在执行: 结束后按常规重新入队
+      }
+      entry->parked = false;
+      const time_point deadline = entry->kind == Kind::Cron ? cron_deadline(*entry) : fresh_now() + entry->resume_in;
+      if (deadline == time_point::max())
+      {
+        entry->cancelled = true;  // cron 不再触发
+        ++cancelled_;
+        if (entry->running == 0)
+        {
+          release(entry);
+        }
+        return true;
+      }
+      entry->deadline = to_ticks(deadline);
+      queue_.push(entry);
+      earliest = queue_.earliest() == entry->deadline;
+    }
+    if (earliest)
+    {
+      cv_.notify_one();
+    }
+    return true;
+  }
+
+  /// @brief Gets the number of live timers
+  std::size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size() - cancelled_;
+  }
+
+  /// @brief Selects how cancelled timers leave the queue
+  /// @param mode `Eager` removes them right away, `Lazy` leaves tombstones
+  /// @param compact_ratio In lazy mode, the queue is compacted once tombstones exceed this share of its nodes
+  void set_cancel_mode(TimerCancelMode mode, double compact_ratio = 0.5)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancel_mode_ = mode;
+    compact_ratio_ = compact_ratio;
+    if (mode == TimerCancelMode::Eager && tombstones_ != 0)
+    {
+      compact();
+    }
+  }
+
+  /// @brief Gets the scheduler counters
+  TimerSchedulerStats stats() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TimerSchedulerStats s;
+    s.timers = entries_.size() - cancelled_;
+    s.tombstones = tombstones_;
+    s.compactions = compactions_;
+    s.tombstones_skipped = tombstones_skipped_;
+    s.delayed = delayed_;
+    s.dropped = dropped_;
+    s.skipped = skipped_;
+    return s;
+  }
+
+  /// @brief Captures the kind, interval, time to the next deadline and paused state of every live timer
+  /// @return Compact binary data for `restore()`, see timer_snapshot.h; one-shot timers that are running are left out
+  std::string snapshot() const
+  {
+    TimerSnapshot snap;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      snap.taken = std::chrono::system_clock::now();
+      const std::int64_t now = to_ticks(fresh_now());
+      snap.timers.reserve(entries_.size());
+      for (const auto &kv : entries_)
+      {
+        const Entry *entry = kv.second.get();
+        if (entry->cancelled)
+        {
+          continue;
+        }
+        TimerRecord r;
+        r.id = entry->id;
+        r.kind = entry->kind;
+        r.paused = entry->paused;
+        r.interval = entry->interval;
+        if (entry->parked)
+        {
+          r.remaining = entry->resume_in;
+        }
+        else if (entry->queued())
+        {
+          r.remaining = duration(entry->deadline - now);
+        }
+        else if (entry->kind != Kind::Once)
+        {
+          r.remaining = duration(entry->deadline + entry->interval.count() - now);  // 正在执行, 之后推进一个周期
+        }
+        else
+        {
+          continue;
+        }
+        snap.timers.push_back(r);
+      }
+    }
+    std::sort(snap.timers.begin(), snap.timers.end(),
+              [](const TimerRecord &a, const TimerRecord &b) { return a.id < b.id; });
+    return snap.encode();
+  }
+
+  /// @brief Schedules every bound timer, resuming the phase and paused state recorded by `snapshot()`
+  /// @param data A snapshot from a previous run; empty or malformed data starts every timer fresh
+  /// @param bindings The timers and their tasks, under ids that stay stable across restarts
+  /// @note A recorded periodic timer keeps its phase: the time between the snapshot and the restore is deducted and
+  ///       the ticks missed meanwhile are skipped, not replayed. A recorded one-shot timer fires after the rest of
+  ///       its delay (right away if that elapsed). Timers not in the snapshot start as with `schedule_*`, and cron
+  ///       timers always follow their expression. Restore before scheduling other timers: ids in use are skipped.
+  TimerRestoreStats restore(const std::string &data, const TimerBindings &bindings)
+  {
+    TimerSnapshot snap;
+    TimerSnapshot::decode(data, snap);
+    const duration down = std::chrono::duration_cast<duration>(std::chrono::system_clock::now() - snap.taken);
+    TimerRestoreStats stats;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_)
+      {
+        return stats;
+      }
+      const time_point now = fresh_now();
+      for (const TimerBindings::Binding &b : bindings.items())
+      {
+        if (entries_.find(b.id) != entries_.end())
+        {
+          ++stats.conflicts;
+          continue;
+        }
+        std::unique_ptr<Entry> entry(new Entry);
+        entry->id = b.id;
+        entry->kind = b.kind;
+        entry->priority = b.priority;
+        entry->interval = b.interval;
+        entry->cron = b.cron;
+        entry->utc_offset = b.utc_offset;
+        entry->task = b.task;
+        const TimerRecord *r = snap.find(b.id);
+        duration wait = b.interval;
+        if (r != nullptr && r->kind == b.kind)
+        {
+          wait = resume_wait(*r, b.interval, down);
+          entry->paused = r->paused;
+          ++stats.resumed;
+        }
+        else
+        {
+          ++stats.fresh;
+        }
+        const time_point deadline = b.kind == Kind::Cron ? cron_deadline(*entry) : now + wait;
+        if (deadline == time_point::max())
+        {
+          continue;  // cron 不再触发
+        }
+        entry->deadline = to_ticks(deadline);
+        if (entry->paused)
+        {
+          park(entry.get());
+        }
+        else
+        {
+          queue_.push(entry.get());
+        }
+        next_id_ = b.id > next_id_ ? b.id : next_id_;  // 之后 schedule_* 分配的 id 不会与之冲突
+        entries_.emplace(b.id, std::move(entry));
+      }
+    }
+    cv_.notify_one();
+    return stats;
+  }
+
+  /// @brief Runs tasks on a worker pool instead of the dispatch thread
+  /// @param executor The pool, see timer_executor.h; must outlive the scheduler. nullptr runs tasks inline again.
+  /// @note With an executor, periodic and cron timers are re-armed when their tick is dispatched, so a slow
+  ///       downstream does not shift their phase; ticks of one timer may then run concurrently unless it is
+  ///       single-flight (see `set_single_flight`). `TimerNext` results are applied when the task returns.
+  ///       The executor's overflow policy decides what happens when its queue is full.
+  void set_executor(TimerExecutor *executor)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    executor_ = executor;
+  }
+
+  /// @brief Sets whether a timer allows at most one run in flight
+  /// @note With an executor, a tick that expires while the previous one is still queued or running is skipped
+  ///       (counted in `stats().skipped`). Without an executor every timer is already single-flight.
+  /// @return false if the timer does not exist
+  bool set_single_flight(TimerId id, bool single_flight = true)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end() || it->second->cancelled)
+    {
+      return false;
+    }
+    it->second->single_flight = single_flight;
+    return true;
+  }
+
+  /// @brief Sets how low-priority timers are shed when the dispatch thread falls behind
+  /// @note Checked right before each task of a batch runs, so timers below `policy.protect` that would start more
+  ///       than `policy.max_lag` late are delayed or dropped. Higher priorities run first, so they are shed last.
+  void set_overload_policy(const TimerOverloadPolicy &policy)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    overload_ = policy;
+  }
+
+  /// @brief Sets a callback invoked on the dispatch thread once per batch of expired timers, before their tasks run
+  /// @note The span is only valid during the call; the callback must not throw. Pass an empty function to remove it.
+  void on_expired(TimerBatchHandler handler)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch_handler_ = std::move(handler);
+  }
+
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+  /// @brief Sets the handler invoked when a task throws; `TimerAction::Stop` cancels the failing timer
+  /// @note The default is `TimerErrorPolicy::report_and_stop()`.
+  void set_error_handler(TimerErrorHandler handler)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_handler_ = std::move(handler);
+  }
+#endif
+
+  /// @brief Stops the dispatch thread and drops all timers; waits for a running task to finish
+  /// @note With an executor it also waits for the ticks queued or running there, so it must not be called from them.
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id())
+    {
+      thread_.join();
+    }
+  }
+
+ private:
+  using duration = typename Clock::duration;
+  using time_point = typename Clock::time_point;
+
+  static const std::size_t kMinCompaction = 64;  // 墓碑少于此数时不压缩
+
+  using Kind = TimerKind;
+
+  /// @brief 定时器条目, 以 TimerNode 作为队列节点
+  struct Entry : TimerNode
+  {
+    Kind kind{Kind::Once};
+    TimerPriority priority{TimerPriority::Normal};
+    bool cancelled{false};                   // 执行期间被取消, 或在延迟取消模式下成为墓碑
+    bool single_flight{false};               // 执行器模式下最多一次在途
+    std::uint32_t running{0};                // 正在执行 (或在执行器中排队) 的次数, 非零时不能回收
+    std::atomic<std::uint32_t> failures{0};  // 连续失败次数, 执行器模式下可能被多个工作线程更新
+    bool paused{false};                      // 已暂停: 不在队列中, 恢复后继续
+    bool parked{false};                      // 暂停期间持有下一次到期时间 (resume_in); 否则正在执行
+    duration resume_in{0};                   // 暂停时距离下一次到期的剩余时间
+    duration interval{0};
+    CronExpr cron;
+    std::chrono::minutes utc_offset{0};
+    std::function<TimerNext()> task;
+  };
+
+  template <typename Func>
+  static std::unique_ptr<Entry> make_entry(Kind kind, duration interval, TimerPriority priority, Func &&f)
+  {
+    using Task = typename std::decay<Func>::type;
+    std::unique_ptr<Entry> entry(new Entry);
+    entry->kind = kind;
+    entry->priority = priority;
+    entry->interval = interval;
+    entry->task = simple_timer::detail::TaskWrapper<Task>{std::forward<Func>(f)};
+    return entry;
+  }
+
+  static std::int64_t to_ticks(time_point t)
+  {
+    return t.time_since_epoch().count();
+  }
+
+  /// @brief 读取时钟源的当前时间; CachedClock 的缓存只在批次开始时刷新, 供任务使用, 调度器自身的计算不使用它,
+  ///        否则一批慢任务之后的重新入队时间与延迟都以批次开始时刻计算
+  static time_point fresh_now()
+  {
+    return simple_timer::detail::ClockRefresh<Clock>::read();
+  }
+
+  /// @brief 转换为 steady_clock 时间点 (所有时钟源都使用 steady_clock 的纪元)
+  static std::chrono::steady_clock::time_point to_steady(std::int64_t ticks)
+  {
+    using steady = std::chrono::steady_clock;
+    return steady::time_point(std::chrono::duration_cast<steady::duration>(duration(ticks)));
+  }
+
+  /// @brief 由 cron 表达式计算下一次触发的单调时钟时间
+  static time_point cron_deadline(const Entry &entry)
+  {
+    const auto wall_now = std::chrono::system_clock::now();
+    const auto wall_next = entry.cron.next(wall_now, entry.utc_offset);
+    if (wall_next == std::chrono::system_clock::time_point::max())
+    {
+      return time_point::max();
+    }
+    return fresh_now() + std::chrono::duration_cast<duration>(wall_next - wall_now);
+  }
+
+  TimerId add(std::unique_ptr<Entry> entry, time_point deadline)
+  {
+    bool earliest = false;
+    TimerId id = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_)
+      {
+        return 0;
+      }
+      id = ++next_id_;
+      entry->id = id;
+      entry->deadline = to_ticks(deadline);
+      queue_.push(entry.get());
+      earliest = queue_.earliest() == entry->deadline;
+      entries_.emplace(id, std::move(entry));
+    }
+    if (earliest)
+    {
+      cv_.notify_one();  // 新定时器最早到期, 需要缩短调度线程的等待
+    }
+    return id;
+  }
+
+  /// @brief 一次性清除队列中的所有墓碑 (需持有 mutex_)
+  void compact()
+  {
+    std::vector<TimerId> &dead = dead_ids_;
+    dead.clear();
+    queue_.remove_if([&dead](TimerNode *node) {
+      if (static_cast<Entry *>(node)->cancelled)
+      {
+        dead.push_back(node->id);
+        return true;
+      }
+      return false;
+    });
+    for (TimerId id : dead)
+    {
+      entries_.erase(id);
+    }
+    cancelled_ -= dead.size();
+    tombstones_ = 0;
+    ++compactions_;
+  }
+
+  /// @brief 按定时器类型推进到下一次到期时间 (需持有 mutex_)
+  /// @return false 表示没有下一次: 单次定时器, 或不会再触发的 cron
+  bool advance(Entry *entry)
+  {
+    if (entry->kind == Kind::Periodic)
+    {
+      entry->deadline += entry->interval.count();  // 精确推进, 避免累计误差
+      return true;
+    }
+    if (entry->kind == Kind::Cron)
+    {
+      const time_point deadline = cron_deadline(*entry);
+      entry->deadline = to_ticks(deadline);
+      return deadline != time_point::max();
+    }
+    return false;
+  }
+
+  /// @brief 回收一个定时器 (需持有 mutex_)
+  void release(Entry *entry)
+  {
+    if (entry->cancelled)
+    {
+      --cancelled_;
+    }
+    entries_.erase(entry->id);
+  }
+
+  /// @brief 任务执行后根据返回值重新入队或回收 (需持有 mutex_)
+  void rearm(Entry *entry, const TimerNext &next)
+  {
+    bool keep = !entry->cancelled && next.action != TimerAction::Stop;
+    if (keep)
+    {
+      if (next.action == TimerAction::RescheduleIn)
+      {
+        entry->deadline = to_ticks(fresh_now() + next.delay);
+      }
+      else
+      {
+        keep = advance(entry);
+      }
+    }
+    if (keep && entry->paused)
+    {
+      park(entry);  // 执行期间被暂停
+    }
+    else if (keep)
+    {
+      queue_.push(entry);
+    }
+    else
+    {
+      release(entry);
+    }
+  }
+
+  /// @brief 由快照记录计算恢复后距离下一次到期的时间
+  /// @param interval 当前绑定的周期, 可能与快照中的不同
+  /// @param down 从拍摄快照到恢复经过的墙上时间; 暂停的定时器不走时
+  static duration resume_wait(const TimerRecord &r, duration interval, duration down)
+  {
+    duration wait = r.paused ? r.remaining : r.remaining - down;
+    if (r.kind == Kind::Periodic && interval > duration::zero())
+    {
+      wait = wait > interval ? interval : wait;  // 周期变短时不超过一个新周期
+      if (wait < duration::zero())
+      {
+        const duration behind = (-wait) % interval;  // 跳过停机期间错过的周期, 保持相位
+        wait = behind == duration::zero() ? behind : interval - behind;
+      }
+    }
+    return wait < duration::zero() ? duration::zero() : wait;
+  }
+
+  /// @brief 暂停的定时器不入队, 只记下距离到期的剩余时间 (需持有 mutex_)
+  void park(Entry *entry)
+  {
+    const std::int64_t left = entry->deadline - to_ticks(fresh_now());
+    entry->parked = true;
+    entry->resume_in = duration(left > 0 ? left : 0);
+  }
+
+  /// @brief 执行器模式下一次执行结束 (或被丢弃) 后应用返回值 (需持有 mutex_)
+  /// @note 周期与 cron 定时器在派发时已重新入队, 这里只处理 Stop / RescheduleIn 与单次定时器的回收
+  void finish(Entry *entry, const TimerNext &next)
+  {
+    --entry->running;
+    --in_flight_;
+    if (!entry->cancelled)
+    {
+      if (next.action == TimerAction::Stop)
+      {
+        if (entry->queued())
+        {
+          queue_.erase(entry);
+        }
+        entry->cancelled = true;  // 其他在途的执行结束后不再重新入队
+        ++cancelled_;
+      }
+      else if (next.action == TimerAction::RescheduleIn)
+      {
+        if (entry->queued())
+        {
+          queue_.erase(entry);
+        }
+        entry->deadline = to_ticks(fresh_now() + next.delay);
+        if (entry->paused)
+        {
+          park(entry);
+        }
+        else
+        {
+          queue_.push(entry);
+          if (queue_.earliest() == entry->deadline)
+          {
+            cv_.notify_all();
+          }
+        }
+      }
+      else if (!entry->queued() && !entry->parked && entry->running == 0)
+      {
+        entry->cancelled = true;  // 单次定时器执行完毕, 在下面回收
+        ++cancelled_;
+      }
+    }
+    if (entry->cancelled && entry->running == 0)
+    {
+      release(entry);
+    }
+    if (stopping_ && in_flight_ == 0)
+    {
+      cv_.notify_all();
+    }
+  }
+
+  /// @brief 过载时是否降级该定时器, 降级时写入代替执行的返回值
+  /// @param deadline 本次的计划到期时间
+  /// @note 落后程度在每个任务开始前重新读取时钟计算, 不使用批次开始时缓存的时间.
+  ///       推迟的周期定时器按 Continue 处理: 逐个周期推进, 直到某个周期的落后不超过 max_lag 才执行,
+  ///       相位不变; 若以当前时刻重新入队, 之后的每次触发都会永久偏移
+  static bool shed(const Entry *entry, std::int64_t deadline, const TimerOverloadPolicy &overload, TimerNext &result)
+  {
+    if (overload.action == TimerOverloadPolicy::Action::None || entry->priority >= overload.protect ||
+        to_ticks(fresh_now()) - deadline <= overload.max_lag.count())
+    {
+      return false;
+    }
+    if (overload.action == TimerOverloadPolicy::Action::Delay && entry->kind != Kind::Periodic)
+    {
+      result = TimerNext(duration::zero());  // 以当前时刻重新入队
+    }
+    else
+    {
+      result = TimerAction::Continue;  // 按正常执行完毕处理: 周期推进, 单次删除
+    }
+    return true;
+  }
+
+  /// @brief 投递到执行器的一次执行
+  struct Tick
+  {
+    BasicTimerScheduler *self;
+    Entry *entry;  // running 非零期间不会被回收
+    TimerOverloadPolicy overload;
+    std::int64_t deadline;  // 本次的计划到期时间; entry->deadline 在派发时已推进
+
+    void operator()(bool run) const
+    {
+      TimerNext next;  // 被执行器丢弃时按 Continue 处理
+      const bool shed_tick = run && shed(entry, deadline, overload, next);
+      if (run && !shed_tick)
+      {
+        next = self->execute(entry, deadline);
+      }
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      if (shed_tick)
+      {
+        ++(overload.action == TimerOverloadPolicy::Action::Delay ? self->delayed_ : self->dropped_);
+      }
+      self->finish(entry, next);
+    }
+  };
+
+  /// @brief 执行一个任务 (不持有 mutex_), 异常交给错误处理器
+  /// @param deadline 本次的计划到期时间 (执行器模式下 entry->deadline 可能已被调度线程推进)
+  TimerNext execute(Entry *entry, std::int64_t deadline)
+  {
+    SIMPLE_TIMER_TRACE_EVENT(Fire, entry->id, to_ticks(fresh_now()) - deadline);
+    SIMPLE_TIMER_TRACE_EVENT(TaskBegin, entry->id, 0);
+#ifdef SIMPLE_TIMER_NO_EXCEPTIONS
+    (void)deadline;
+    TimerNext next = entry->task();
+    SIMPLE_TIMER_TRACE_EVENT(TaskEnd, entry->id, 0);
+    return next;
+#else
+    std::exception_ptr error;
+    try
+    {
+      TimerNext next = entry->task();
+      SIMPLE_TIMER_TRACE_EVENT(TaskEnd, entry->id, 0);
+      entry->failures = 0;
+      return next;
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+    SIMPLE_TIMER_TRACE_EVENT(TaskEnd, entry->id, 0);
+    TimerErrorHandler handler;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      handler = error_handler_;
+    }
+    return simple_timer::detail::handle_error(
+      handler, TimerError{error, entry->id, to_steady(deadline), ++entry->failures});
+#endif
+  }
+
+  /// @brief 调度线程主循环: 一次加锁取出所有到期定时器, 解锁后连续执行 (或投递到执行器), 再一次加锁统一重新入队
+  void run()
+  {
+    std::vector<TimerNode *> batch;  // 本轮到期的节点, 容量跨轮复用
+    std::vector<TimerNext> results;  // 与 batch 一一对应的任务返回值
+    std::vector<TimerId> ids;        // 传给批量回调的 id
+    std::vector<Tick> ticks;         // 执行器模式下本轮要投递的执行
+    TimerBatchHandler batch_handler;
+    TimerOverloadPolicy overload;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+      if (queue_.empty())
+      {
+        cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+        continue;
+      }
+      const std::int64_t now = to_ticks(simple_timer::detail::ClockRefresh<Clock>::now());
+      const std::int64_t earliest = queue_.earliest();
+      if (earliest > now)
+      {
+        cv_.wait_for(lock, duration(earliest - now));  // 被新的更早定时器或 stop 唤醒后重新检查
+        continue;
+      }
+
+      batch.clear();
+      queue_.pop_expired(now, batch);
+      std::size_t live = 0;
+      bool mixed = false;  // 本批是否包含不同优先级
+      for (TimerNode *node : batch)
+      {
+        Entry *entry = static_cast<Entry *>(node);
+        if (entry->cancelled)
+        {
+          entries_.erase(entry->id);  // 墓碑: 跳过并回收
+          --tombstones_;
+          --cancelled_;
+          ++tombstones_skipped_;
+          continue;
+        }
+        mixed = mixed || (live != 0 && entry->priority != static_cast<Entry *>(batch[0])->priority);
+        batch[live++] = node;
+      }
+      batch.resize(live);
+      if (batch.empty())
+      {
+        continue;
+      }
+      if (mixed)
+      {
+        std::stable_sort(batch.begin(), batch.end(), [](const TimerNode *a, const TimerNode *b) {
+          return static_cast<const Entry *>(a)->priority > static_cast<const Entry *>(b)->priority;
+        });  // 同一优先级内保持到期顺序
+      }
+      overload = overload_;
+      if (batch_handler_)
+      {
+        batch_handler = batch_handler_;
+      }
+      else if (batch_handler)
+      {
+        batch_handler = nullptr;
+      }
+      TimerExecutor *executor = executor_;
+      if (executor != nullptr)
+      {
+        // 执行器模式: 派发时即重新入队, 保持周期相位; 单飞定时器上一次未结束时跳过本次
+        ticks.clear();
+        for (TimerNode *node : batch)
+        {
+          Entry *entry = static_cast<Entry *>(node);
+          const std::int64_t deadline = entry->deadline;
+          const bool skip = entry->single_flight && entry->running != 0;
+          if (advance(entry))
+          {
+            queue_.push(entry);
+          }
+          if (skip)
+          {
+            ++skipped_;
+            if (!entry->queued())
+            {
+              entry->cancelled = true;  // cron 不再触发: 由在途的执行结束后回收
+              ++cancelled_;
+            }
+            continue;
+          }
+          ++entry->running;
+          ++in_flight_;
+          ticks.push_back(Tick{this, entry, overload, deadline});
+        }
+      }
+      else
+      {
+        for (TimerNode *node : batch)
+        {
+          ++static_cast<Entry *>(node)->running;
+        }
+      }
+      if (batch_handler)
+      {
+        ids.clear();
+        for (TimerNode *node : batch)
+        {
+          ids.push_back(node->id);  // 在锁内收集: 执行器模式下节点可能被工作线程回收
+        }
+      }
+      lock.unlock();
+
+      if (batch_handler)
+      {
+        batch_handler(TimerIdSpan{ids.data(), ids.size()});
+      }
+      if (executor != nullptr)
+      {
+        for (const Tick &tick : ticks)
+        {
+          executor->post(tick.entry->id, tick.entry->priority, tick);  // 可能按溢出策略阻塞或就地执行
+        }
+        lock.lock();
+        continue;
+      }
+
+      results.resize(batch.size());
+      std::uint64_t delayed = 0;
+      std::uint64_t dropped = 0;
+      for (std::size_t i = 0; i < batch.size(); ++i)
+      {
+        Entry *entry = static_cast<Entry *>(batch[i]);
+        if (shed(entry, entry->deadline, overload, results[i]))
+        {
+          ++(overload.action == TimerOverloadPolicy::Action::Delay ? delayed : dropped);
+          continue;
+        }
+        results[i] = execute(entry, entry->deadline);
+      }
+
+      lock.lock();
+      delayed_ += delayed;
+      dropped_ += dropped;
+      for (std::size_t i = 0; i < batch.size(); ++i)
+      {
+        Entry *entry = static_cast<Entry *>(batch[i]);
+        --entry->running;
+        rearm(entry, results[i]);
+      }
+    }
+    cv_.wait(lock, [this]() { return in_flight_ == 0; });  // 等待执行器中的执行结束或被丢弃
+    queue_.clear();
+    entries_.clear();
+  }
+
+  mutable std::mutex mutex_;                                     // 保护以下所有成员
+  std::condition_variable cv_;                                   // 唤醒调度线程
+  Queue queue_;                                                  // 到期时间队列
+  std::unordered_map<TimerId, std::unique_ptr<Entry>> entries_;  // 所有存活的定时器
+  std::size_t cancelled_{0};                                     // entries_ 中已取消但尚未回收的个数
+  std::size_t in_flight_{0};                                     // 已投递到执行器但尚未结束的执行个数
+  TimerExecutor *executor_{nullptr};                             // 执行器, 为空时在调度线程上执行
+  TimerId next_id_{0};                                           // id 生成器
+  bool stopping_{false};                                         // 是否已停止
+  TimerBatchHandler batch_handler_;                              // 批量到期回调
+  TimerCancelMode cancel_mode_{TimerCancelMode::Eager};          // 取消方式
+  double compact_ratio_{0.5};                                    // 墓碑占比超过此值时压缩
+  std::size_t tombstones_{0};                                    // 队列中的墓碑个数
+  std::uint64_t compactions_{0};                                 // 压缩次数
+  std::uint64_t tombstones_skipped_{0};                          // 到期时跳过的墓碑个数
+  std::vector<TimerId> dead_ids_;                                // 压缩时收集的墓碑 id, 容量复用
+  TimerOverloadPolicy overload_;                                 // 过载降级策略
+  std::uint64_t delayed_{0};                                     // 过载时推迟的次数
+  std::uint64_t dropped_{0};                                     // 过载时丢弃的次数
+  std::uint64_t skipped_{0};                                     // 单飞定时器跳过的次数
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+  TimerErrorHandler error_handler_{TimerErrorPolicy::report_and_stop()};  // 任务异常处理器
+#endif
+  std::thread thread_;  // 调度线程, 最后初始化
+};
+
+/// @brief The default scheduler, backed by a binary heap
+using TimerScheduler = BasicTimerScheduler<TimerHeap>;
+
+/// @brief A scheduler backed by a flat SIMD-scanned deadline array, for a few thousand frequently re-armed timers
+using FlatTimerScheduler = BasicTimerScheduler<FlatTimerQueue>;
+
+/// @brief A scheduler backed by a ladder queue, for millions of timers with widely spread deadlines
+using LadderTimerScheduler = BasicTimerScheduler<LadderTimerQueue>;
+
+#endif  // SIMPLE_TIMER_TIMER_SCHEDULER_H
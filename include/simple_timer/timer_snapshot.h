@@ -0,0 +1,143 @@
+/**
+ * @file: timer_snapshot.h
+ * @description: Compact binary snapshot of a scheduler's timers, see `BasicTimerScheduler::snapshot` / `restore`.
+ *               A restarted process resumes each timer's phase instead of firing every periodic job at startup.
+ *
+ * - Layout (little-endian): magic `STSN`, version (u8), wall-clock time of the snapshot (i64 ns since the
+ *   system_clock epoch), timer count (u32), then 26 bytes per timer: id (u64), kind (u8), flags (u8, bit 0 =
+ *   paused), interval (i64 ns) and time until the next deadline at snapshot time (i64 ns).
+ * - Records are sorted by id. Tasks are not serialized; they are re-attached by id, see `TimerBindings`.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_SNAPSHOT_H
+#define SIMPLE_TIMER_TIMER_SNAPSHOT_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simple_timer.h"
+
+/// @brief Kind of a scheduler timer
+enum class TimerKind : unsigned char
+{
+  Once = 0,      // 单次
+  Periodic = 1,  // 周期
+  Cron = 2,      // cron 表达式, 相位由墙上时钟决定
+};
+
+/// @brief One timer in a snapshot
+struct TimerRecord
+{
+  TimerId id{0};
+  TimerKind kind{TimerKind::Once};
+  bool paused{false};
+  std::chrono::nanoseconds interval{0};   // 周期; 单次定时器为原始延迟, cron 为 0
+  std::chrono::nanoseconds remaining{0};  // 快照时距下一次到期的时间, 已过期时为负; 暂停时为剩余时间
+};
+
+/// @brief Decoded scheduler snapshot
+struct TimerSnapshot
+{
+  std::chrono::system_clock::time_point taken;  // 拍摄快照的墙上时间, 用于扣除停机时间
+  std::vector<TimerRecord> timers;              // 按 id 升序
+
+  /// @brief Finds the record of a timer
+  /// @return nullptr if the timer is not in the snapshot
+  const TimerRecord *find(TimerId id) const
+  {
+    auto it = std::lower_bound(timers.begin(), timers.end(), id,
+                               [](const TimerRecord &r, TimerId key) { return r.id < key; });
+    return it != timers.end() && it->id == id ? &*it : nullptr;
+  }
+
+  /// @brief Serializes the snapshot; records must be sorted by id
+  std::string encode() const
+  {
+    std::string out;
+    out.reserve(kHeader + kRecord * timers.size());
+    out.append("STSN", 4);
+    out.push_back(static_cast<char>(kVersion));
+    put(out, static_cast<std::uint64_t>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(taken.time_since_epoch()).count()));
+    put(out, static_cast<std::uint32_t>(timers.size()));
+    for (const TimerRecord &r : timers)
+    {
+      put(out, static_cast<std::uint64_t>(r.id));
+      out.push_back(static_cast<char>(r.kind));
+      out.push_back(static_cast<char>(r.paused ? 1 : 0));
+      put(out, static_cast<std::uint64_t>(r.interval.count()));
+      put(out, static_cast<std::uint64_t>(r.remaining.count()));
+    }
+    return out;
+  }
+
+  /// @brief Parses a snapshot
+  /// @return false if the data is empty, truncated, of another version or otherwise malformed; `out` is then empty
+  static bool decode(const std::string &data, TimerSnapshot &out)
+  {
+    out.timers.clear();
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data.data());
+    if (data.size() < kHeader || data.compare(0, 4, "STSN") != 0 || p[4] != kVersion)
+    {
+      return false;
+    }
+    const std::uint64_t count = get(p + 13, 4);
+    if (data.size() != kHeader + kRecord * count)
+    {
+      return false;
+    }
+    out.taken = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+      std::chrono::nanoseconds(static_cast<std::int64_t>(get(p + 5, 8)))));
+    out.timers.resize(static_cast<std::size_t>(count));
+    p += kHeader;
+    for (std::size_t i = 0; i < out.timers.size(); ++i, p += kRecord)
+    {
+      TimerRecord &r = out.timers[i];
+      r.id = static_cast<TimerId>(get(p, 8));
+      r.kind = static_cast<TimerKind>(p[8]);
+      r.paused = (p[9] & 1) != 0;
+      r.interval = std::chrono::nanoseconds(static_cast<std::int64_t>(get(p + 10, 8)));
+      r.remaining = std::chrono::nanoseconds(static_cast<std::int64_t>(get(p + 18, 8)));
+      if (r.id == 0 || (i != 0 && out.timers[i - 1].id >= r.id) || p[8] > static_cast<unsigned char>(TimerKind::Cron) ||
+          p[9] > 1)
+      {
+        out.timers.clear();
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  static const unsigned char kVersion = 1;
+  static const std::size_t kHeader = 17;  // magic + 版本 + 时间 + 个数
+  static const std::size_t kRecord = 26;  // 每个定时器的字节数
+
+  template <typename T>
+  static void put(std::string &out, T v)
+  {
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+      out.push_back(static_cast<char>(static_cast<unsigned char>(v >> (8 * i))));
+    }
+  }
+
+  static std::uint64_t get(const unsigned char *p, std::size_t n)
+  {
+    std::uint64_t v = 0;
+    for (std::size_t i = n; i-- > 0;)
+    {
+      v = (v << 8) | p[i];
+    }
+    return v;
+  }
+};
+
+#endif  // SIMPLE_TIMER_TIMER_SNAPSHOT_H
@@ -0,0 +1,788 @@
+/**
+ * @file: timer_store.h
+ * @description: Durable timers ("expire order 42 in 24h") that survive crashes and restarts, for millions of entries.
+ *               Every timer and its payload is appended to an mmap'd log; a periodically checkpointed index keeps the
+ *               live timers sorted by deadline. Recovery maps the index and loads only the timers due within a
+ *               horizon window, replaying just the log written since the last checkpoint, so opening a store with
+ *               10M+ timers takes milliseconds. Later timers stay on disk until the window reaches them.
+ *
+ * - Deadlines are wall-clock times (`system_clock`), so they keep their meaning across restarts.
+ * - Delivery is at-least-once: a fired timer stays in the store until its handler acknowledges it.
+ * - Appends land in the shared mapping and survive a process crash at once; `sync()` also makes them survive an OS
+ *   crash or power loss. Torn records at the end of the log are detected by a checksum and dropped.
+ * - A checkpoint rewrites the log with only the live timers once most of it is dead.
+ * - Files are `<path>.log` and `<path>.idx`, in native byte order. POSIX only.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_STORE_H
+#define SIMPLE_TIMER_TIMER_STORE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "simple_timer.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "timer_store.h requires POSIX mmap"
+#endif
+
+namespace simple_timer
+{
+namespace detail
+{
+/// @brief 以 MAP_SHARED 映射的文件, 可写时可以增长
+class MappedFile
+{
+ public:
+  MappedFile() = default;
+  ~MappedFile()
+  {
+    close();
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /// @brief 打开并映射整个文件; 可写时文件不存在则创建, 不足 min_size 时用 0 补齐
+  bool open(const std::string &path, bool writable, std::size_t min_size = 0)
+  {
+    close();
+    fd_ = ::open(path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    struct stat st;
+    if (fd_ < 0 || ::fstat(fd_, &st) != 0)
+    {
+      close();
+      return false;
+    }
+    writable_ = writable;
+    created_ = st.st_size == 0;
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (!map(writable && size < min_size ? min_size : size))
+    {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  /// @brief 改变文件大小并重新映射, 之前取得的指针全部失效
+  bool map(std::size_t size)
+  {
+    if (data_ != nullptr)
+    {
+      ::munmap(data_, size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+    if (writable_ && ::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+    {
+      return false;
+    }
+    if (size != 0)
+    {
+      void *p = ::mmap(nullptr, size, writable_ ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd_, 0);
+      if (p == MAP_FAILED)
+      {
+        return false;
+      }
+      data_ = static_cast<char *>(p);
+    }
+    size_ = size;
+    return true;
+  }
+
+  /// @brief 把映射中的修改写回磁盘
+  bool sync()
+  {
+    return data_ == nullptr || ::msync(data_, size_, MS_SYNC) == 0;
+  }
+
+  void close()
+  {
+    if (data_ != nullptr)
+    {
+      ::munmap(data_, size_);
+    }
+    if (fd_ >= 0)
+    {
+      ::close(fd_);
+    }
+    fd_ = -1;
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  char *data() const
+  {
+    return data_;
+  }
+  std::size_t size() const
+  {
+    return size_;
+  }
+  bool created() const
+  {
+    return created_;
+  }
+
+ private:
+  int fd_{-1};
+  char *data_{nullptr};
+  std::size_t size_{0};
+  bool writable_{false};
+  bool created_{false};  // 打开时文件为空 (新建)
+};
+}  // namespace detail
+}  // namespace simple_timer
+
+/// @brief A fired durable timer
+struct DurableTimer
+{
+  TimerId id;
+  std::chrono::system_clock::time_point deadline;
+  std::string payload;
+};
+
+/// @brief Options of a `DurableTimerStore`
+struct DurableStoreOptions
+{
+  std::chrono::seconds horizon{std::chrono::minutes(10)};  // 只把此窗口内到期的定时器载入内存
+  std::size_t checkpoint_every{1u << 20};                  // 追加这么多条日志后由下一次 poll() 写索引, 0 表示只手动写
+};
+
+/// @brief Counters of a `DurableTimerStore`
+struct DurableStoreStats
+{
+  std::size_t loaded{0};         // 已载入内存窗口的定时器个数, 含已触发但未确认的
+  std::size_t deferred{0};       // 留在磁盘上尚未载入的个数, 下次检查点前可能包含已删除的
+  std::size_t log_bytes{0};      // 日志已用字节数
+  std::uint64_t checkpoints{0};  // 写索引的次数
+  std::uint64_t compactions{0};  // 重写日志的次数
+};
+
+/// @brief Crash-safe store of durable one-shot timers
+/// @note Thread-safe. Drive it with `poll()`, e.g. from a `TimerScheduler` task or an event loop sized by
+///       `next_deadline()`.
+class DurableTimerStore
+{
+ public:
+  using clock = std::chrono::system_clock;
+
+  DurableTimerStore() = default;
+  ~DurableTimerStore()
+  {
+    close();
+  }
+
+  DurableTimerStore(const DurableTimerStore &) = delete;
+  DurableTimerStore &operator=(const DurableTimerStore &) = delete;
+
+  /// @brief Opens or creates a store and recovers its timers
+  /// @param path Path prefix of the `.log` and `.idx` files
+  /// @return false if the files cannot be opened or the log is not a timer store log
+  bool open(const std::string &path, const DurableStoreOptions &options = DurableStoreOptions())
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    close_locked();
+    path_ = path;
+    options_ = options;
+    if (!log_.open(path + ".log", true, kInitialLog))
+    {
+      return false;
+    }
+    if (log_.created())
+    {
+      write_log_header(log_.data(), 1);
+    }
+    else if (log_.size() < kLogHeader || std::memcmp(log_.data(), "STLG", 4) != 0 ||
+             get<std::uint32_t>(log_.data() + 4) != kVersion)
+    {
+      log_.close();
+      return false;
+    }
+    generation_ = get<std::uint64_t>(log_.data() + 8);
+    const TimerId logged_next = get<std::uint64_t>(log_.data() + 16);  // 压缩时写入; 新日志为 0
+
+    std::size_t offset = kLogHeader;  // 从此处开始重放日志
+    if (index_.open(path + ".idx", false) && index_.size() >= kIndexHeader &&
+        std::memcmp(index_.data(), "STIX", 4) == 0 && get<std::uint32_t>(index_.data() + 4) == kVersion &&
+        get<std::uint64_t>(index_.data() + 8) == generation_ &&
+        index_.size() == kIndexHeader + kIndexEntry * get<std::uint64_t>(index_.data() + 32) &&
+        get<std::uint64_t>(index_.data() + 16) <= log_.size())
+    {
+      offset = static_cast<std::size_t>(get<std::uint64_t>(index_.data() + 16));
+      next_id_ = get<std::uint64_t>(index_.data() + 24);
+      index_count_ = static_cast<std::size_t>(get<std::uint64_t>(index_.data() + 32));
+    }
+    else
+    {
+      index_.close();  // 没有索引, 或索引属于压缩前的日志: 重放整个日志
+    }
+    const bool full_replay = index_count_ == 0 && offset == kLogHeader;
+    replay(offset);
+    next_id_ = logged_next > next_id_ ? logged_next : next_id_;  // 只重放压缩后的日志时, 最新的 id 可能已被删除
+    refill(ticks(clock::now()));
+    if (full_replay && !later_.empty())
+    {
+      checkpoint_locked();  // 重建索引, 下次启动不必再重放整个日志
+    }
+    return true;
+  }
+
+  /// @brief Writes the mapping back and closes the files; timers stay in the store
+  void close()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    close_locked();
+  }
+
+  /// @brief Adds a durable timer
+  /// @param deadline When it fires
+  /// @param payload What the handler needs to act on it, e.g. an order id
+  /// @return The timer id, or 0 if the store is not open or the log cannot grow
+  /// @note Only appends to the log; the index is written by `poll()` or `checkpoint()`.
+  TimerId add(clock::time_point deadline, const std::string &payload)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_.data() == nullptr)
+    {
+      return 0;
+    }
+    Slot slot{ticks(deadline), next_id_, 0, 0};
+    if (!append(kAdd, slot, payload.data(), payload.size()))
+    {
+      return 0;
+    }
+    ++next_id_;
+    if (slot.deadline <= window_end_)
+    {
+      load(slot);
+    }
+    else
+    {
+      later_.push_back(slot);
+    }
+    return slot.id;
+  }
+
+  /// @brief Cancels a pending timer, or acknowledges a fired one
+  /// @note Timers that are not loaded yet are not looked up on disk: removing an unknown or already removed id just
+  ///       appends a record that the next checkpoint drops.
+  void remove(TimerId id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_.data() == nullptr || id == 0 || id >= next_id_)
+    {
+      return;
+    }
+    Slot slot{0, id, 0, 0};
+    if (!append(kRemove, slot, nullptr, 0))
+    {
+      return;
+    }
+    auto it = window_.find(id);
+    if (it != window_.end())
+    {
+      order_.erase(std::make_pair(it->second.deadline, id));
+      window_.erase(it);
+    }
+    else
+    {
+      removed_.insert(id);  // 在索引或 later_ 中, 载入或写检查点时跳过
+    }
+  }
+
+  /// @brief Delivers the timers due at `now`
+  /// @param handler Called for each due timer as `bool(const DurableTimer &)`, without the store's lock; returning
+  ///        true acknowledges (removes) the timer, false leaves it to be delivered again after the next recovery
+  /// @return The number of delivered timers
+  /// @note Also writes the index once `checkpoint_every` records have been appended since the last one, so the
+  ///       rewrite runs on the thread that drives the store rather than inside `add()` or `remove()`.
+  template <typename Func>
+  std::size_t poll(clock::time_point now, Func &&handler)
+  {
+    std::vector<DurableTimer> due;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const std::int64_t t = ticks(now);
+      if (t > window_end_ - horizon() / 2)
+      {
+        refill(t);  // 窗口过半后向前滑动, 每次只读取索引中新进入窗口的一段
+      }
+      while (!order_.empty() && order_.begin()->first <= t)
+      {
+        const TimerId id = order_.begin()->second;
+        order_.erase(order_.begin());
+        Live &live = window_[id];
+        live.fired = true;  // 确认前仍留在存储中
+        due.push_back(DurableTimer{id, to_time(live.deadline), payload(live.offset)});
+      }
+      maybe_checkpoint();
+    }
+    for (const DurableTimer &timer : due)
+    {
+      if (handler(timer))
+      {
+        remove(timer.id);
+      }
+    }
+    return due.size();
+  }
+
+  /// @brief Gets the earliest deadline that `poll()` should be called at
+  /// @return `time_point::max()` if the store is empty; the end of the loaded window if nothing in it is due earlier
+  clock::time_point next_deadline() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!order_.empty())
+    {
+      return to_time(order_.begin()->first);
+    }
+    return cursor_ < index_count_ || !later_.empty() ? to_time(window_end_ - horizon() / 2) : clock::time_point::max();
+  }
+
+  /// @brief Writes the index now, and rewrites the log if most of it is dead
+  /// @note Runs on the calling thread and holds the lock while it reads the whole index, so call it when idle.
+  /// @return false if the files could not be written; the previous index stays valid. If the log was compacted but
+  ///         the new log cannot be mapped, the store is closed and `open()` recovers it from the new files.
+  bool checkpoint()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_.data() != nullptr && checkpoint_locked();
+  }
+
+  /// @brief Flushes the log to disk so that it survives an OS crash or power loss
+  bool sync()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_.sync();
+  }
+
+  /// @brief Gets the store counters
+  DurableStoreStats stats() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DurableStoreStats s;
+    s.loaded = window_.size();
+    s.deferred = index_count_ - cursor_ + later_.size();
+    s.log_bytes = tail_;
+    s.checkpoints = checkpoints_;
+    s.compactions = compactions_;
+    return s;
+  }
+
+ private:
+  static const std::uint32_t kVersion = 1;
+  static const std::size_t kLogHeader = 24;    // "STLG", 版本, 代数, 压缩时的下一个 id
+  static const std::size_t kIndexHeader = 40;  // "STIX", 版本, 代数, 日志偏移, 下一个 id, 条目数
+  static const std::size_t kIndexEntry = 32;   // id, 到期时间, 日志偏移, 记录长度, 保留
+  static const std::size_t kRecordHeader = 8;  // 正文长度, 校验和
+  static const std::size_t kRecordBody = 17;   // 类型, id, 到期时间, 之后是负载
+  static const std::size_t kInitialLog = 1u << 20;
+  static const std::size_t kPage = 4096;
+  static const unsigned char kAdd = 1;
+  static const unsigned char kRemove = 2;
+
+  /// @brief 一个定时器在磁盘上的位置
+  struct Slot
+  {
+    std::int64_t deadline;
+    TimerId id;
+    std::size_t offset;  // 记录在日志中的偏移
+    std::size_t size;    // 记录的总字节数
+  };
+
+  /// @brief 已载入窗口的定时器
+  struct Live
+  {
+    std::int64_t deadline;
+    std::size_t offset;
+    std::size_t size;
+    bool fired;  // 已交给处理函数, 等待确认
+  };
+
+  template <typename T>
+  static T get(const char *p)
+  {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+  }
+
+  template <typename T>
+  static void put(char *p, T v)
+  {
+    std::memcpy(p, &v, sizeof(T));
+  }
+
+  /// @brief FNV-1a, 用于识别崩溃时写了一半的记录
+  static std::uint32_t checksum(const char *p, std::size_t n)
+  {
+    std::uint32_t h = 2166136261u;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      h = (h ^ static_cast<unsigned char>(p[i])) * 16777619u;
+    }
+    return h;
+  }
+
+  static std::int64_t ticks(clock::time_point t)
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+  }
+
+  static clock::time_point to_time(std::int64_t ns)
+  {
+    return clock::time_point(std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(ns)));
+  }
+
+  std::int64_t horizon() const
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(options_.horizon).count();
+  }
+
+  static void write_log_header(char *p, std::uint64_t generation)
+  {
+    std::memcpy(p, "STLG", 4);
+    put<std::uint32_t>(p + 4, kVersion);
+    put<std::uint64_t>(p + 8, generation);
+    put<std::uint64_t>(p + 16, 0);
+  }
+
+  /// @brief 读取第 i 个索引条目
+  Slot index_entry(std::size_t i) const
+  {
+    const char *p = index_.data() + kIndexHeader + i * kIndexEntry;
+    return Slot{get<std::int64_t>(p + 8), get<std::uint64_t>(p), static_cast<std::size_t>(get<std::uint64_t>(p + 16)),
+                get<std::uint32_t>(p + 24)};
+  }
+
+  std::string payload(std::size_t offset) const
+  {
+    const std::size_t body = get<std::uint32_t>(log_.data() + offset);
+    return std::string(log_.data() + offset + kRecordHeader + kRecordBody, body - kRecordBody);
+  }
+
+  /// @brief 追加一条记录, 成功时写入 slot 的偏移和长度 (需持有 mutex_)
+  bool append(unsigned char type, Slot &slot, const char *data, std::size_t size)
+  {
+    const std::size_t body = kRecordBody + size;
+    const std::size_t need = tail_ + kRecordHeader + body;
+    const std::size_t capacity = log_.size();
+    if (need > capacity && !log_.map(std::max(need, capacity * 2)))
+    {
+      log_.map(capacity);  // 磁盘空间不足: 保持原来的映射
+      return false;
+    }
+    char *p = log_.data() + tail_;
+    p[kRecordHeader] = static_cast<char>(type);
+    put<std::uint64_t>(p + kRecordHeader + 1, slot.id);
+    put<std::int64_t>(p + kRecordHeader + 9, slot.deadline);
+    if (size != 0)
+    {
+      std::memcpy(p + kRecordHeader + kRecordBody, data, size);
+    }
+    put<std::uint32_t>(p + 4, checksum(p + kRecordHeader, body));
+    put<std::uint32_t>(p, static_cast<std::uint32_t>(body));  // 最后写长度, 之前崩溃时这条记录不可见
+    slot.offset = tail_;
+    slot.size = kRecordHeader + body;
+    tail_ = need;
+    ++since_checkpoint_;
+    return true;
+  }
+
+  /// @brief 重放上次检查点之后的日志, 截断写了一半的尾部记录 (需持有 mutex_)
+  void replay(std::size_t offset)
+  {
+    std::unordered_map<TimerId, Slot> added;
+    const char *base = log_.data();
+    while (offset + kRecordHeader + kRecordBody <= log_.size())
+    {
+      const std::size_t body = get<std::uint32_t>(base + offset);
+      if (body < kRecordBody || body > log_.size() - offset - kRecordHeader ||
+          checksum(base + offset + kRecordHeader, body) != get<std::uint32_t>(base + offset + 4))
+      {
+        break;
+      }
+      const char *p = base + offset + kRecordHeader;
+      const TimerId id = get<std::uint64_t>(p + 1);
+      if (p[0] == kAdd)
+      {
+        added[id] = Slot{get<std::int64_t>(p + 9), id, offset, kRecordHeader + body};
+      }
+      else if (added.erase(id) == 0)
+      {
+        removed_.insert(id);  // 删除的是索引中的定时器
+      }
+      next_id_ = id >= next_id_ ? id + 1 : next_id_;
+      offset += kRecordHeader + body;
+    }
+    tail_ = offset;
+    // 清除残缺记录, 以及其后可能残留的旧记录 (掉电时页面可能乱序落盘), 直到遇到全零的一页
+    for (std::size_t at = offset; at < log_.size(); at += kPage)
+    {
+      char *page = log_.data() + at;
+      const std::size_t n = log_.size() - at < kPage ? log_.size() - at : kPage;
+      if (std::all_of(page, page + n, [](char c) { return c == 0; }))
+      {
+        break;
+      }
+      std::memset(page, 0, n);
+    }
+    for (const auto &kv : added)
+    {
+      later_.push_back(kv.second);
+    }
+  }
+
+  void load(const Slot &slot)
+  {
+    window_[slot.id] = Live{slot.deadline, slot.offset, slot.size, false};
+    order_.insert(std::make_pair(slot.deadline, slot.id));
+  }
+
+  /// @brief 把窗口推进到 now + horizon, 载入新进入窗口的定时器 (需持有 mutex_)
+  void refill(std::int64_t now)
+  {
+    window_end_ = now + horizon();
+    for (; cursor_ < index_count_; ++cursor_)
+    {
+      const Slot slot = index_entry(cursor_);
+      if (slot.deadline > window_end_)
+      {
+        break;
+      }
+      if (removed_.erase(slot.id) == 0)
+      {
+        load(slot);
+      }
+    }
+    for (std::size_t i = 0; i < later_.size();)
+    {
+      if (later_[i].deadline > window_end_)
+      {
+        ++i;
+        continue;
+      }
+      if (removed_.erase(later_[i].id) == 0)
+      {
+        load(later_[i]);
+      }
+      later_[i] = later_.back();
+      later_.pop_back();
+    }
+  }
+
+  /// @brief 自上次检查点后追加的记录够多时写索引 (需持有 mutex_)
+  void maybe_checkpoint()
+  {
+    if (options_.checkpoint_every != 0 && since_checkpoint_ >= options_.checkpoint_every)
+    {
+      checkpoint_locked();
+    }
+  }
+
+  /// @brief 写索引: 先是窗口中的定时器, 再归并索引余下部分与 later_, 整体按到期时间有序 (需持有 mutex_)
+  bool checkpoint_locked()
+  {
+    std::vector<Slot> head;
+    head.reserve(window_.size());
+    std::size_t live_bytes = 0;
+    for (const auto &kv : window_)
+    {
+      head.push_back(Slot{kv.second.deadline, kv.first, kv.second.offset, kv.second.size});
+      live_bytes += kv.second.size;
+    }
+    std::vector<Slot> rest;
+    rest.reserve(later_.size());
+    for (const Slot &slot : later_)
+    {
+      if (removed_.count(slot.id) == 0)
+      {
+        rest.push_back(slot);
+        live_bytes += slot.size;
+      }
+    }
+    for (std::size_t i = cursor_; i < index_count_; ++i)
+    {
+      const Slot slot = index_entry(i);
+      live_bytes += removed_.count(slot.id) == 0 ? slot.size : 0;
+    }
+    auto by_deadline = [](const Slot &a, const Slot &b) { return a.deadline < b.deadline; };
+    std::sort(head.begin(), head.end(), by_deadline);
+    std::sort(rest.begin(), rest.end(), by_deadline);
+
+    // 日志中超过一半是已删除的记录时, 只把存活的记录拷贝到新日志 (新的代数)
+    const bool compact = tail_ > kInitialLog && tail_ - kLogHeader > 2 * live_bytes;
+    simple_timer::detail::MappedFile fresh;
+    std::size_t fresh_tail = kLogHeader;
+    if (compact)
+    {
+      std::remove((path_ + ".log.tmp").c_str());
+      const std::size_t size = kLogHeader + live_bytes;
+      if (!fresh.open(path_ + ".log.tmp", true, size > kInitialLog ? size : kInitialLog))
+      {
+        return false;
+      }
+      write_log_header(fresh.data(), generation_ + 1);
+      put<std::uint64_t>(fresh.data() + 16, next_id_);  // 被删除的 id 不在新日志中, 没有索引时据此避免重用
+    }
+    if (!log_.sync())
+    {
+      return false;  // 索引不能指向尚未落盘的记录
+    }
+
+    const std::string tmp = path_ + ".idx.tmp";
+    std::FILE *f = std::fopen(tmp.c_str(), "wb");
+    if (f == nullptr)
+    {
+      return false;
+    }
+    std::uint64_t count = 0;
+    char header[kIndexHeader] = {};
+    bool ok = std::fwrite(header, 1, kIndexHeader, f) == kIndexHeader;  // 条目数最后回填
+    auto emit = [&](Slot slot) -> std::size_t {
+      if (compact)
+      {
+        std::memcpy(fresh.data() + fresh_tail, log_.data() + slot.offset, slot.size);
+        slot.offset = fresh_tail;
+        fresh_tail += slot.size;
+      }
+      char entry[kIndexEntry] = {};
+      put<std::uint64_t>(entry, slot.id);
+      put<std::int64_t>(entry + 8, slot.deadline);
+      put<std::uint64_t>(entry + 16, slot.offset);
+      put<std::uint32_t>(entry + 24, static_cast<std::uint32_t>(slot.size));
+      ok = ok && std::fwrite(entry, 1, kIndexEntry, f) == kIndexEntry;
+      ++count;
+      return slot.offset;
+    };
+    for (const Slot &slot : head)
+    {
+      const std::size_t offset = emit(slot);
+      window_[slot.id].offset = offset;  // 压缩后记录移动到新日志中
+    }
+    std::size_t j = 0;
+    for (std::size_t i = cursor_; i < index_count_; ++i)
+    {
+      const Slot slot = index_entry(i);
+      if (removed_.count(slot.id) != 0)
+      {
+        continue;
+      }
+      for (; j < rest.size() && rest[j].deadline < slot.deadline; ++j)
+      {
+        emit(rest[j]);
+      }
+      emit(slot);
+    }
+    for (; j < rest.size(); ++j)
+    {
+      emit(rest[j]);
+    }
+
+    const std::uint64_t generation = compact ? generation_ + 1 : generation_;
+    std::memcpy(header, "STIX", 4);
+    put<std::uint32_t>(header + 4, kVersion);
+    put<std::uint64_t>(header + 8, generation);
+    put<std::uint64_t>(header + 16, compact ? fresh_tail : tail_);
+    put<std::uint64_t>(header + 24, next_id_);
+    put<std::uint64_t>(header + 32, count);
+    ok = ok && std::fseek(f, 0, SEEK_SET) == 0 && std::fwrite(header, 1, kIndexHeader, f) == kIndexHeader;
+    ok = ok && std::fflush(f) == 0 && ::fsync(::fileno(f)) == 0;
+    ok = std::fclose(f) == 0 && ok;
+    if (ok && compact)
+    {
+      // 先替换日志再替换索引: 两次改名之间崩溃时, 索引的代数与日志不符, 恢复时重放 (压缩后的) 整个日志
+      ok = fresh.sync() && std::rename((path_ + ".log.tmp").c_str(), (path_ + ".log").c_str()) == 0;
+    }
+    if (!ok || std::rename(tmp.c_str(), (path_ + ".idx").c_str()) != 0)
+    {
+      std::remove(tmp.c_str());
+      if (compact)
+      {
+        std::remove((path_ + ".log.tmp").c_str());
+      }
+      return false;
+    }
+
+    if (compact)
+    {
+      fresh.close();
+      if (!log_.open(path_ + ".log", true))
+      {
+        close_locked();  // 新的日志与索引都已落盘, 重新 open() 即可恢复
+        return false;
+      }
+      generation_ = generation;
+      tail_ = fresh_tail;
+      ++compactions_;
+    }
+    index_.open(path_ + ".idx", false);
+    index_count_ = static_cast<std::size_t>(count);
+    cursor_ = head.size();
+    later_.clear();
+    removed_.clear();
+    since_checkpoint_ = 0;
+    ++checkpoints_;
+    return true;
+  }
+
+  void close_locked()
+  {
+    log_.sync();
+    log_.close();
+    index_.close();
+    window_.clear();
+    order_.clear();
+    later_.clear();
+    removed_.clear();
+    generation_ = 0;
+    tail_ = 0;
+    next_id_ = 1;
+    cursor_ = 0;
+    index_count_ = 0;
+    window_end_ = 0;
+    since_checkpoint_ = 0;
+  }
+
+  mutable std::mutex mutex_;                          // 保护以下所有成员
+  std::string path_;                                  // 文件路径前缀
+  DurableStoreOptions options_;                       // 选项
+  simple_timer::detail::MappedFile log_;              // 追加写的日志
+  simple_timer::detail::MappedFile index_;            // 上次检查点写出的索引, 按到期时间有序
+  std::uint64_t generation_{0};                       // 日志代数, 每次压缩加一
+  std::size_t tail_{0};                               // 日志的写入位置
+  TimerId next_id_{1};                                // id 生成器
+  std::size_t cursor_{0};                             // 索引中第一个尚未载入的条目
+  std::size_t index_count_{0};                        // 索引条目数
+  std::int64_t window_end_{0};                        // 窗口终点, 到期时间不晚于此的定时器都在内存中
+  std::unordered_map<TimerId, Live> window_;          // 已载入的定时器
+  std::set<std::pair<std::int64_t, TimerId>> order_;  // 窗口中未触发的定时器, 按到期时间有序
+  std::vector<Slot> later_;                           // 检查点之后追加的、窗口之外的定时器
+  std::unordered_set<TimerId> removed_;               // 已删除但仍在索引或 later_ 中的 id
+  std::size_t since_checkpoint_{0};                   // 上次检查点之后追加的记录数
+  std::uint64_t checkpoints_{0};                      // 写索引的次数
+  std::uint64_t compactions_{0};                      // 重写日志的次数
+};
+
+#endif  // SIMPLE_TIMER_TIMER_STORE_H
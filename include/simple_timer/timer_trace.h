@@ -0,0 +1,257 @@
+/**
+ * @file: timer_trace.h
+ * @description: Optional tracing of timer activity, dumped as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+ *               Compiled in only when `SIMPLE_TIMER_TRACE` is defined before including `simple_timer.h`; otherwise the
+ *               trace points expand to nothing and cost nothing.
+ *
+ * - Events: fire (with lateness), task begin/end, pause, resume and interval change, for `SimpleTimer` and
+ *   `TimerScheduler`.
+ * - Each thread writes to its own fixed-size ring buffer (`SIMPLE_TIMER_TRACE_CAPACITY` records, a power of two) with
+ *   relaxed atomic stores only: no locks and no allocation after the thread's first event. Old records are overwritten.
+ * - `TimerTrace::chrome_json()` / `write_chrome_json(path)` snapshot all rings on demand, from any thread.
+ *
+ * @license: MIT
+ * @repository: https://github.com/abin-z/SimpleTimer
+ */
+
+#ifndef SIMPLE_TIMER_TIMER_TRACE_H
+#define SIMPLE_TIMER_TIMER_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef SIMPLE_TIMER_TRACE_CAPACITY
+#define SIMPLE_TIMER_TRACE_CAPACITY 4096
+#endif
+
+/// @brief Kind of a trace record
+enum class TraceEvent : std::uint8_t
+{
+  Fire = 0,            // 到达触发时间, arg = 迟到的纳秒数
+  TaskBegin = 1,       // 任务开始执行
+  TaskEnd = 2,         // 任务执行结束
+  Pause = 3,           // 暂停
+  Resume = 4,          // 恢复
+  IntervalChange = 5,  // 修改间隔, arg = 新间隔的纳秒数
+};
+
+/// @brief Process-wide trace sink
+class TimerTrace
+{
+ public:
+  /// @brief Records an event on the calling thread's ring buffer; lock-free
+  /// @param event The event kind
+  /// @param timer The timer id
+  /// @param arg Event argument, see `TraceEvent`
+  static void record(TraceEvent event, std::uint64_t timer, std::int64_t arg = 0) noexcept
+  {
+    Ring *ring = local_ring();
+    if (ring == nullptr)
+    {
+      return;
+    }
+    const std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+    Slot &slot = ring->slots[head & (kCapacity - 1)];
+    slot.ts.store(now_ns(), std::memory_order_relaxed);
+    slot.timer.store(timer, std::memory_order_relaxed);
+    slot.arg.store(arg, std::memory_order_relaxed);
+    slot.event.store(static_cast<std::uint8_t>(event), std::memory_order_relaxed);
+    ring->head.store(head + 1, std::memory_order_release);
+  }
+
+  /// @brief Renders all buffered events as a Chrome trace JSON document
+  /// @note Records overwritten while the snapshot is taken are dropped.
+  static std::string chrome_json()
+  {
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    char buf[256];
+    for (Ring *ring : rings())
+    {
+      const std::uint64_t end = ring->head.load(std::memory_order_acquire);
+      const std::uint64_t begin = end > kCapacity ? end - kCapacity : 0;
+      std::vector<Record> records;
+      records.reserve(static_cast<std::size_t>(end - begin));
+      for (std::uint64_t i = begin; i < end; ++i)
+      {
+        const Slot &slot = ring->slots[i & (kCapacity - 1)];
+        records.push_back(Record{slot.ts.load(std::memory_order_relaxed), slot.timer.load(std::memory_order_relaxed),
+                                 slot.arg.load(std::memory_order_relaxed),
+                                 static_cast<TraceEvent>(slot.event.load(std::memory_order_relaxed))});
+      }
+      const std::uint64_t after = ring->head.load(std::memory_order_acquire);
+      const std::uint64_t valid = after > kCapacity ? after - kCapacity : 0;  // 复制期间被覆盖的记录不可信
+      for (std::uint64_t i = begin; i < end; ++i)
+      {
+        if (i < valid)
+        {
+          continue;
+        }
+        const Record &r = records[static_cast<std::size_t>(i - begin)];
+        const int n = format(buf, sizeof(buf), r, ring->tid);
+        if (n > 0)
+        {
+          out += first ? "\n" : ",\n";
+          out.append(buf, static_cast<std::size_t>(n));
+          first = false;
+        }
+      }
+    }
+    out += "\n],\"displayTimeUnit\":\"ns\"}\n";
+    return out;
+  }
+
+  /// @brief Writes `chrome_json()` to a file
+  /// @return true on success
+  static bool write_chrome_json(const char *path)
+  {
+    std::FILE *f = std::fopen(path, "wb");
+    if (f == nullptr)
+    {
+      return false;
+    }
+    const std::string json = chrome_json();
+    const bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+    return std::fclose(f) == 0 && ok;
+  }
+
+  /// @brief Drops all buffered events
+  /// @note Only call it while no thread is recording.
+  static void clear()
+  {
+    for (Ring *ring : rings())
+    {
+      ring->head.store(0, std::memory_order_release);
+    }
+  }
+
+ private:
+  static const std::uint64_t kCapacity = SIMPLE_TIMER_TRACE_CAPACITY;
+  static_assert((SIMPLE_TIMER_TRACE_CAPACITY & (SIMPLE_TIMER_TRACE_CAPACITY - 1)) == 0,
+                "SIMPLE_TIMER_TRACE_CAPACITY must be a power of two");
+
+  /// @brief 环形缓冲区的一个槽位, 字段用 relaxed 原子读写, 导出时与写入线程并发也没有数据竞争
+  struct Slot
+  {
+    std::atomic<std::int64_t> ts{0};
+    std::atomic<std::uint64_t> timer{0};
+    std::atomic<std::int64_t> arg{0};
+    std::atomic<std::uint8_t> event{0};
+  };
+
+  struct Record
+  {
+    std::int64_t ts;
+    std::uint64_t timer;
+    std::int64_t arg;
+    TraceEvent event;
+  };
+
+  /// @brief 每个线程一个, 只由所属线程写入; 线程退出后仍保留, 以便导出
+  struct Ring
+  {
+    std::uint32_t tid{0};
+    std::atomic<std::uint64_t> head{0};  // 已写入的记录总数
+    Slot slots[SIMPLE_TIMER_TRACE_CAPACITY];
+  };
+
+  struct Registry
+  {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+  };
+
+  static Registry &registry()
+  {
+    static Registry *r = new Registry;  // 故意不释放: 线程退出或静态析构期间仍可能记录
+    return *r;
+  }
+
+  /// @brief 当前线程的缓冲区, 首次使用时注册 (唯一加锁与分配的地方)
+  static Ring *local_ring() noexcept
+  {
+    static thread_local Ring *ring = nullptr;
+    if (ring == nullptr)
+    {
+      Registry &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      std::unique_ptr<Ring> fresh(new (std::nothrow) Ring);
+      if (!fresh)
+      {
+        return nullptr;
+      }
+      fresh->tid = static_cast<std::uint32_t>(r.rings.size() + 1);
+      ring = fresh.get();
+      r.rings.push_back(std::move(fresh));
+    }
+    return ring;
+  }
+
+  static std::vector<Ring *> rings()
+  {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<Ring *> out;
+    for (const std::unique_ptr<Ring> &ring : r.rings)
+    {
+      out.push_back(ring.get());
+    }
+    return out;
+  }
+
+  static std::int64_t now_ns() noexcept
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+  }
+
+  /// @brief 格式化一条 Chrome trace 事件: 任务为 B/E 区间, 其余为线程内的瞬时事件
+  static int format(char *buf, std::size_t size, const Record &r, std::uint32_t tid)
+  {
+    const double ts = static_cast<double>(r.ts) / 1000.0;  // Chrome trace 的时间单位是微秒
+    const unsigned long long timer = static_cast<unsigned long long>(r.timer);
+    const long long arg = static_cast<long long>(r.arg);
+    switch (r.event)
+    {
+    case TraceEvent::Fire:
+      return std::snprintf(buf, size,
+                           "{\"name\":\"fire\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                           "\"args\":{\"timer\":%llu,\"lateness_ns\":%lld}}",
+                           ts, tid, timer, arg);
+    case TraceEvent::TaskBegin:
+      return std::snprintf(buf, size,
+                           "{\"name\":\"timer %llu\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                           "\"args\":{\"timer\":%llu}}",
+                           timer, ts, tid, timer);
+    case TraceEvent::TaskEnd:
+      return std::snprintf(buf, size, "{\"name\":\"timer %llu\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                           timer, ts, tid);
+    case TraceEvent::Pause:
+      return std::snprintf(buf, size,
+                           "{\"name\":\"pause\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                           "\"args\":{\"timer\":%llu}}",
+                           ts, tid, timer);
+    case TraceEvent::Resume:
+      return std::snprintf(buf, size,
+                           "{\"name\":\"resume\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                           "\"args\":{\"timer\":%llu}}",
+                           ts, tid, timer);
+    case TraceEvent::IntervalChange:
+      return std::snprintf(buf, size,
+                           "{\"name\":\"interval\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                           "\"args\":{\"timer\":%llu,\"interval_ns\":%lld}}",
+                           ts, tid, timer, arg);
+    }
+    return 0;
+  }
+};
+
+#endif  // SIMPLE_TIMER_TIMER_TRACE_H
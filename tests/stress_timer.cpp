@@ -0,0 +1,228 @@
+// SimpleTimer 在 CPU 争用下的漂移与延迟压力测试
+// 多个周期 (默认 100us, 1ms, 10ms, 100ms, 1s) 的定时器同时运行, 与忙等的压力线程绑定在同一组核心上.
+// 第 k 次触发相对理想时间点 (start + k * interval) 的延迟记为 lateness:
+//   - 累计漂移 = 最后 10% 触发的 lateness 中位数 - 最初 10% 触发的 lateness 中位数, 检验 next_time += interval_
+//     不会随运行时间累积误差 (固定的唤醒延迟被相减抵消)
+//   - p99 = lateness 的 99 分位
+// 任一周期超出预算时返回 1.
+// 用法: stresstest [--seconds 20] [--cores 1] [--stress 2] [--drift-us 1000] [--p99-us 10000]
+//                  [--periods 100,1000,10000,100000,1000000 (微秒)] [--absolute-sleep]
+
+#include <simple_timer/simple_timer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+  double seconds = 20;
+  unsigned cores = 1;   // 定时器与压力线程共用的核心数
+  unsigned stress = 2;  // 每个核心的压力线程数
+  double drift_us = 1000;
+  double p99_us = 10000;  // 单核上与压力线程竞争时, 唤醒延迟约为一个 CFS 时间片 (数毫秒)
+  std::vector<long long> periods_us{100, 1000, 10000, 100000, 1000000};
+  bool absolute_sleep = false;
+};
+
+/// @brief 一个周期的测量结果
+struct Probe
+{
+  std::chrono::microseconds interval;
+  Clock::time_point start;
+  std::vector<Clock::time_point> stamps;  // 只由该定时器的线程写入, stop() 之后读取
+  std::unique_ptr<SimpleTimer> timer;
+};
+
+bool parse(int argc, char *argv[], Options &opt)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (arg == "--absolute-sleep")
+    {
+      opt.absolute_sleep = true;
+      continue;
+    }
+    if (value == nullptr)
+    {
+      return false;
+    }
+    ++i;
+    if (arg == "--seconds")
+    {
+      opt.seconds = std::atof(value);
+    }
+    else if (arg == "--cores")
+    {
+      opt.cores = static_cast<unsigned>(std::atoi(value));
+    }
+    else if (arg == "--stress")
+    {
+      opt.stress = static_cast<unsigned>(std::atoi(value));
+    }
+    else if (arg == "--drift-us")
+    {
+      opt.drift_us = std::atof(value);
+    }
+    else if (arg == "--p99-us")
+    {
+      opt.p99_us = std::atof(value);
+    }
+    else if (arg == "--periods")
+    {
+      opt.periods_us.clear();
+      for (const char *p = value; p != nullptr; p = std::strchr(p, ','))
+      {
+        p += *p == ',' ? 1 : 0;
+        opt.periods_us.push_back(std::atoll(p));
+      }
+    }
+    else
+    {
+      return false;
+    }
+  }
+  return opt.seconds > 0 && opt.cores > 0 && !opt.periods_us.empty() &&
+         std::all_of(opt.periods_us.begin(), opt.periods_us.end(), [](long long p) { return p > 0; });
+}
+
+/// @brief 把调用线程绑定到前 cores 个可用核心; 之后创建的线程 (定时器与压力线程) 继承该绑定
+bool pin(unsigned cores)
+{
+#if defined(__linux__)
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+  {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  unsigned picked = 0;
+  for (int cpu = 0; cpu < CPU_SETSIZE && picked < cores; ++cpu)
+  {
+    if (CPU_ISSET(cpu, &allowed))
+    {
+      CPU_SET(cpu, &set);
+      ++picked;
+    }
+  }
+  return picked != 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  (void)cores;
+  return false;
+#endif
+}
+
+double median(std::vector<double>::const_iterator first, std::vector<double>::const_iterator last)
+{
+  std::vector<double> v(first, last);
+  std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2), v.end());
+  return v[v.size() / 2];
+}
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  Options opt;
+  if (!parse(argc, argv, opt))
+  {
+    std::fprintf(stderr,
+                 "usage: %s [--seconds S] [--cores N] [--stress N] [--drift-us US] [--p99-us US] "
+                 "[--periods US,US,...] [--absolute-sleep]\n",
+                 argv[0]);
+    return 2;
+  }
+  const bool pinned = pin(opt.cores);
+  std::printf("%.0f s, %u core(s)%s, %u stress thread(s) per core, %s, budgets: drift %.0f us, p99 %.0f us\n",
+              opt.seconds, opt.cores, pinned ? "" : " (not pinned)", opt.stress,
+              opt.absolute_sleep ? "absolute sleep" : "condition variable", opt.drift_us, opt.p99_us);
+
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> stress;
+  for (unsigned i = 0; i < opt.cores * opt.stress; ++i)
+  {
+    stress.emplace_back([&stop]() {
+      volatile std::uint64_t x = 0;
+      while (!stop.load(std::memory_order_relaxed))
+      {
+        x = x * 6364136223846793005ULL + 1;  // 纯计算, 不让出 CPU
+      }
+    });
+  }
+
+  const auto run_for = std::chrono::duration<double>(opt.seconds);
+  std::vector<Probe> probes(opt.periods_us.size());
+  for (std::size_t i = 0; i < probes.size(); ++i)
+  {
+    Probe &p = probes[i];
+    p.interval = std::chrono::microseconds(opt.periods_us[i]);
+    p.stamps.reserve(static_cast<std::size_t>(run_for / p.interval) + 16);
+    p.timer.reset(new SimpleTimer(p.interval));
+    p.timer->set_wait_strategy(opt.absolute_sleep ? TimerWaitStrategy::AbsoluteSleep
+                                                  : TimerWaitStrategy::ConditionVariable);
+  }
+  for (Probe &p : probes)
+  {
+    Probe *self = &p;
+    p.start = Clock::now();
+    p.timer->start([self]() { self->stamps.push_back(Clock::now()); });
+  }
+  std::this_thread::sleep_for(run_for);
+  for (Probe &p : probes)
+  {
+    p.timer->stop();
+  }
+  stop = true;
+  for (std::thread &t : stress)
+  {
+    t.join();
+  }
+
+  std::printf("%12s %10s %10s %10s %10s %12s  %s\n", "period (us)", "fires", "p50", "p99", "max", "drift (us)",
+              "result");
+  bool ok = true;
+  for (const Probe &p : probes)
+  {
+    std::vector<double> lateness;  // 按触发顺序, 微秒
+    for (std::size_t k = 0; k < p.stamps.size(); ++k)
+    {
+      const Clock::time_point ideal = p.start + p.interval * static_cast<long long>(k + 1);
+      lateness.push_back(std::chrono::duration<double, std::micro>(p.stamps[k] - ideal).count());
+    }
+    if (lateness.size() < 2)
+    {
+      std::printf("%12lld %10zu %43s  SKIP (run longer)\n", static_cast<long long>(p.interval.count()),
+                  lateness.size(), "");
+      continue;
+    }
+    const std::size_t decile = lateness.size() / 10 != 0 ? lateness.size() / 10 : 1;
+    const double drift = median(lateness.end() - static_cast<std::ptrdiff_t>(decile), lateness.end()) -
+                         median(lateness.begin(), lateness.begin() + static_cast<std::ptrdiff_t>(decile));
+    std::vector<double> sorted = lateness;
+    std::sort(sorted.begin(), sorted.end());
+    const double p99 = sorted[sorted.size() * 99 / 100];
+    const bool pass = drift <= opt.drift_us && drift >= -opt.drift_us && p99 <= opt.p99_us;
+    ok = ok && pass;
+    std::printf("%12lld %10zu %10.1f %10.1f %10.1f %12.1f  %s\n", static_cast<long long>(p.interval.count()),
+                lateness.size(), sorted[sorted.size() / 2], p99, sorted.back(), drift, pass ? "ok" : "FAIL");
+  }
+  return ok ? 0 : 1;
+}
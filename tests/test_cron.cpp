@@ -0,0 +1,63 @@
+#include <simple_timer/cron_expr.h>
+
+#include <catch.hpp>
+#include <chrono>
+#include <cstdint>
+
+using namespace std::chrono;
+
+namespace
+{
+/// 构造 UTC 时间点
+system_clock::time_point utc(std::int64_t y, unsigned mon, unsigned d, int h, int m, int s = 0)
+{
+  const std::int64_t days = simple_timer::detail::days_from_civil(y, mon, d);
+  return system_clock::time_point(duration_cast<system_clock::duration>(seconds(days * 86400 + h * 3600 + m * 60 + s)));
+}
+}  // namespace
+
+TEST_CASE("CronExpr parses valid and rejects invalid expressions", "[CronExpr]")
+{
+  REQUIRE(CronExpr("* * * * *").valid());
+  REQUIRE(CronExpr("0,30 9-17 * * MON-FRI").valid());
+  REQUIRE(CronExpr("*/15 */2 1-10/3 jan,Jun 0-7").valid());
+  REQUIRE(CronExpr("@daily").valid());
+
+  REQUIRE_FALSE(CronExpr().valid());
+  REQUIRE_FALSE(CronExpr("* * * *").valid());       // 字段不足
+  REQUIRE_FALSE(CronExpr("* * * * * *").valid());   // 字段过多
+  REQUIRE_FALSE(CronExpr("60 * * * *").valid());    // 超出范围
+  REQUIRE_FALSE(CronExpr("5-1 * * * *").valid());   // 反向区间
+  REQUIRE_FALSE(CronExpr("*/0 * * * *").valid());   // 步长为 0
+  REQUIRE_FALSE(CronExpr("* * * FOO *").valid());   // 未知名称
+  REQUIRE(CronExpr("* * 30 2 *").next(utc(2024, 1, 1, 0, 0)) == system_clock::time_point::max());  // 永不触发
+}
+
+TEST_CASE("CronExpr computes next fire time", "[CronExpr]")
+{
+  // 每分钟: 下一整分钟, 严格晚于参考时间
+  REQUIRE(CronExpr("* * * * *").next(utc(2024, 5, 10, 12, 0, 0)) == utc(2024, 5, 10, 12, 1));
+  REQUIRE(CronExpr("* * * * *").next(utc(2024, 5, 10, 12, 0, 59)) == utc(2024, 5, 10, 12, 1));
+
+  // 每小时第 30 分钟
+  REQUIRE(CronExpr("30 * * * *").next(utc(2024, 5, 10, 12, 30)) == utc(2024, 5, 10, 13, 30));
+
+  // 每天 00:00, 跨年
+  REQUIRE(CronExpr("@daily").next(utc(2024, 12, 31, 23, 59)) == utc(2025, 1, 1, 0, 0));
+
+  // 工作日 9 点: 2024-05-10 是星期五, 下一个是星期一 05-13
+  REQUIRE(CronExpr("0 9 * * MON-FRI").next(utc(2024, 5, 10, 9, 0)) == utc(2024, 5, 13, 9, 0));
+
+  // 闰日: 2025 年之后下一个 2 月 29 日是 2028 年
+  REQUIRE(CronExpr("0 0 29 2 *").next(utc(2024, 3, 1, 0, 0)) == utc(2028, 2, 29, 0, 0));
+
+  // 日期与星期同时受限时取并集: 每月 13 日或星期五
+  REQUIRE(CronExpr("0 0 13 * 5").next(utc(2024, 9, 1, 0, 0)) == utc(2024, 9, 6, 0, 0));
+  REQUIRE(CronExpr("0 0 13 * 5").next(utc(2024, 9, 12, 0, 0)) == utc(2024, 9, 13, 0, 0));
+
+  // 星期 7 等同于星期日: 2024-05-12 是星期日
+  REQUIRE(CronExpr("0 12 * * 7").next(utc(2024, 5, 10, 0, 0)) == utc(2024, 5, 12, 12, 0));
+
+  // 固定时区偏移: UTC+8 的 08:00 即 UTC 的 00:00
+  REQUIRE(CronExpr("0 8 * * *").next(utc(2024, 5, 10, 1, 0), hours(8)) == utc(2024, 5, 11, 0, 0));
+}
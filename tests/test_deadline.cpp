@@ -0,0 +1,81 @@
+#include <simple_timer/deadline.h>
+
+#include <atomic>
+#include <catch.hpp>
+#include <chrono>
+#include <future>
+#include <thread>
+
+using namespace std::chrono;
+
+TEST_CASE("Deadline fires when the work does not complete in time", "[Deadline]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> timeouts{0};
+
+  Deadline deadline(scheduler, milliseconds(20), [&]() { ++timeouts; });
+  std::this_thread::sleep_for(milliseconds(80));
+  REQUIRE(timeouts == 1);
+  REQUIRE(deadline.expired());
+  REQUIRE_FALSE(deadline.complete());  // 超时已胜出
+  REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE("Deadline completion cancels the queue node", "[Deadline]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> timeouts{0};
+  {
+    Deadline deadline(scheduler, milliseconds(50), [&]() { ++timeouts; });
+    REQUIRE(scheduler.size() == 1);
+    REQUIRE(deadline.complete());
+    REQUIRE_FALSE(deadline.complete());
+    REQUIRE(scheduler.size() == 0);
+  }
+  {
+    Deadline deadline(scheduler, milliseconds(50), [&]() { ++timeouts; });
+  }  // 析构即完成
+  REQUIRE(scheduler.size() == 0);
+  std::this_thread::sleep_for(milliseconds(100));
+  REQUIRE(timeouts == 0);
+}
+
+TEST_CASE("Deadline wrap forwards only in-time completions", "[Deadline]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> timeouts{0};
+  std::atomic<int> done{0};
+
+  Deadline fast(scheduler, milliseconds(50), [&]() { ++timeouts; });
+  auto on_done = fast.wrap([&]() { ++done; });
+  on_done();
+  on_done();  // 重复完成被忽略
+  REQUIRE(done == 1);
+
+  Deadline slow(scheduler, milliseconds(10), [&]() { ++timeouts; });
+  auto on_late = slow.wrap([&]() { ++done; });
+  std::this_thread::sleep_for(milliseconds(60));
+  on_late();
+  REQUIRE(done == 1);
+  REQUIRE(timeouts == 1);
+}
+
+TEST_CASE("with_timeout fires only for futures that are not ready", "[Deadline]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> timeouts{0};
+
+  std::promise<int> ready;
+  auto ok = with_timeout(scheduler, ready.get_future(), milliseconds(20), [&]() { ++timeouts; });
+  ready.set_value(7);
+
+  std::promise<int> stuck;
+  auto late = with_timeout(scheduler, stuck.get_future(), milliseconds(20), [&]() { ++timeouts; });
+
+  std::this_thread::sleep_for(milliseconds(80));
+  REQUIRE(timeouts == 1);
+  REQUIRE(ok.get() == 7);
+  REQUIRE(late.wait_for(seconds(0)) == std::future_status::timeout);
+  REQUIRE(scheduler.size() == 0);
+  stuck.set_value(0);
+}
@@ -0,0 +1,131 @@
+#include <simple_timer/debounce.h>
+
+#include <atomic>
+#include <catch.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace std::chrono;
+
+TEST_CASE("Debouncer fires once after a burst of events", "[Debouncer]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> counter{0};
+  Debouncer debouncer(scheduler, milliseconds(50), [&]() { counter++; });
+
+  for (int i = 0; i < 10; ++i)  // 100ms 的事件突发, 间隔小于 delay
+  {
+    debouncer.trigger();
+    std::this_thread::sleep_for(milliseconds(10));
+  }
+  REQUIRE(counter == 0);  // 突发期间不触发
+  REQUIRE(debouncer.pending());
+
+  std::this_thread::sleep_for(milliseconds(150));
+  REQUIRE(counter == 1);
+  REQUIRE_FALSE(debouncer.pending());
+
+  debouncer.trigger();  // 新的一轮
+  std::this_thread::sleep_for(milliseconds(150));
+  REQUIRE(counter == 2);
+}
+
+TEST_CASE("Debouncer cancel drops the pending call", "[Debouncer]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> counter{0};
+  Debouncer debouncer(scheduler, milliseconds(30), [&]() { counter++; });
+
+  debouncer.trigger();
+  debouncer.cancel();
+  std::this_thread::sleep_for(milliseconds(100));
+
+  REQUIRE(counter == 0);
+  REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE("Throttler limits calls to one per interval", "[Throttler]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> counter{0};
+  Throttler throttler(scheduler, milliseconds(50), [&]() { counter++; });
+
+  throttler.trigger();
+  std::this_thread::sleep_for(milliseconds(20));
+  REQUIRE(counter == 1);  // 空闲时第一个事件立即执行
+
+  auto until = steady_clock::now() + milliseconds(240);
+  while (steady_clock::now() < until)  // 约 240ms 的高频事件
+  {
+    throttler.trigger();
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  std::this_thread::sleep_for(milliseconds(120));
+
+  REQUIRE(counter >= 4);  // 每 50ms 最多一次
+  REQUIRE(counter <= 7);
+  REQUIRE(scheduler.size() == 0);  // 无事件后自动撤防
+}
+
+TEST_CASE("Debouncer survives cancel from inside the callback during concurrent triggers", "[Debouncer]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> counter{0};
+  Debouncer debouncer(scheduler, milliseconds(2), [&]() {
+    counter++;
+    std::this_thread::sleep_for(milliseconds(1));  // 另一线程此时的 trigger() 看到已布防
+    debouncer.cancel();                            // 回调中取消, 与另一线程的 trigger() 竞争
+  });
+
+  std::atomic<bool> done{false};
+  std::thread producer([&]() {
+    for (int i = 0; !done; ++i)
+    {
+      debouncer.trigger();
+      std::this_thread::sleep_for(i % 3 == 0 ? milliseconds(3) : microseconds(100));
+    }
+  });
+  std::this_thread::sleep_for(milliseconds(300));
+  done = true;
+  producer.join();
+  std::this_thread::sleep_for(milliseconds(30));
+  REQUIRE(counter > 0);
+  REQUIRE_FALSE(debouncer.pending());
+
+  const int before = counter;
+  debouncer.trigger();  // 之后的事件仍然恰好触发一次
+  std::this_thread::sleep_for(milliseconds(50));
+  REQUIRE(counter == before + 1);
+  REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE("Throttler survives cancel from inside the callback during concurrent triggers", "[Throttler]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> counter{0};
+  Throttler throttler(scheduler, milliseconds(2), [&]() {
+    counter++;
+    std::this_thread::sleep_for(milliseconds(1));
+    throttler.cancel();
+  });
+
+  std::atomic<bool> done{false};
+  std::thread producer([&]() {
+    for (int i = 0; !done; ++i)
+    {
+      throttler.trigger();
+      std::this_thread::sleep_for(i % 3 == 0 ? milliseconds(3) : microseconds(100));
+    }
+  });
+  std::this_thread::sleep_for(milliseconds(300));
+  done = true;
+  producer.join();
+  std::this_thread::sleep_for(milliseconds(30));
+  REQUIRE(counter > 0);
+
+  const int before = counter;
+  throttler.trigger();
+  std::this_thread::sleep_for(milliseconds(50));
+  REQUIRE(counter == before + 1);
+  REQUIRE(scheduler.size() == 0);
+}
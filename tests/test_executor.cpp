@@ -0,0 +1,236 @@
+#include <simple_timer/timer_scheduler.h>
+
+#include <atomic>
+#include <catch.hpp>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace
+{
+/// @brief 占住执行器唯一的工作线程, 直到 open()
+struct Gate
+{
+  std::atomic<bool> open{false};
+  std::atomic<bool> entered{false};
+
+  TimerExecutor::Job job()
+  {
+    return [this](bool) {
+      entered = true;
+      while (!open)
+      {
+        std::this_thread::sleep_for(milliseconds(1));
+      }
+    };
+  }
+
+  void wait_entered() const
+  {
+    while (!entered)
+    {
+      std::this_thread::sleep_for(milliseconds(1));
+    }
+  }
+};
+}  // namespace
+
+TEST_CASE("TimerExecutor runs queued jobs by priority", "[TimerExecutor]")
+{
+  TimerExecutor executor(1, 16);
+  Gate gate;
+  std::mutex mtx;
+  std::vector<int> order;
+  auto job = [&](int n) {
+    return [&, n](bool run) {
+      REQUIRE(run);
+      std::lock_guard<std::mutex> lock(mtx);
+      order.push_back(n);
+    };
+  };
+
+  executor.post(0, TimerPriority::Normal, gate.job());
+  gate.wait_entered();
+  executor.post(1, TimerPriority::Low, job(1));
+  executor.post(2, TimerPriority::Normal, job(2));
+  executor.post(3, TimerPriority::Critical, job(3));
+  executor.post(4, TimerPriority::Normal, job(4));
+  gate.open = true;
+  std::this_thread::sleep_for(milliseconds(50));
+
+  std::lock_guard<std::mutex> lock(mtx);
+  REQUIRE(order == std::vector<int>{3, 2, 4, 1});
+  REQUIRE(executor.stats().executed == 5);
+}
+
+TEST_CASE("TimerExecutor overflow policies keep the queue bounded", "[TimerExecutor]")
+{
+  Gate gate;
+  std::atomic<int> ran{0};
+  std::atomic<int> dropped{0};
+  std::mutex mtx;
+  std::vector<int> ran_ids;
+  auto job = [&](int n) {
+    return [&, n](bool run) {
+      if (!run)
+      {
+        ++dropped;
+        return;
+      }
+      ++ran;
+      std::lock_guard<std::mutex> lock(mtx);
+      ran_ids.push_back(n);
+    };
+  };
+
+  SECTION("drop new")
+  {
+    TimerExecutor executor(1, 2, ExecutorOverflow::DropNew);
+    executor.post(0, TimerPriority::Normal, gate.job());
+    gate.wait_entered();
+    executor.post(1, TimerPriority::Normal, job(1));
+    executor.post(2, TimerPriority::Normal, job(2));
+    executor.post(3, TimerPriority::Normal, job(3));
+    REQUIRE(dropped == 1);  // 被丢弃的任务也会以 run == false 调用一次
+    gate.open = true;
+    std::this_thread::sleep_for(milliseconds(50));
+    std::lock_guard<std::mutex> lock(mtx);
+    REQUIRE(ran_ids == std::vector<int>{1, 2});
+    REQUIRE(executor.stats().dropped == 1);
+    REQUIRE(executor.stats().high_water == 2);
+  }
+
+  SECTION("drop the oldest tick of the same timer")
+  {
+    TimerExecutor executor(1, 2, ExecutorOverflow::DropOldest);
+    executor.post(0, TimerPriority::Normal, gate.job());
+    gate.wait_entered();
+    executor.post(7, TimerPriority::Normal, job(1));
+    executor.post(8, TimerPriority::Normal, job(2));
+    executor.post(7, TimerPriority::Normal, job(3));  // 替换定时器 7 排队中的 1
+    executor.post(9, TimerPriority::Normal, job(4));  // 队列中没有定时器 9: 丢弃新任务
+    REQUIRE(dropped == 2);
+    gate.open = true;
+    std::this_thread::sleep_for(milliseconds(50));
+    std::lock_guard<std::mutex> lock(mtx);
+    REQUIRE(ran_ids == std::vector<int>{2, 3});
+  }
+
+  SECTION("run inline")
+  {
+    TimerExecutor executor(1, 1, ExecutorOverflow::RunInline);
+    executor.post(0, TimerPriority::Normal, gate.job());
+    gate.wait_entered();
+    executor.post(1, TimerPriority::Normal, job(1));
+    const std::thread::id caller = std::this_thread::get_id();
+    std::thread::id where;
+    executor.post(2, TimerPriority::Normal, [&](bool) { where = std::this_thread::get_id(); });
+    REQUIRE(where == caller);
+    REQUIRE(executor.stats().inlined == 1);
+    gate.open = true;
+  }
+
+  SECTION("block")
+  {
+    TimerExecutor executor(1, 1, ExecutorOverflow::Block);
+    executor.post(0, TimerPriority::Normal, gate.job());
+    gate.wait_entered();
+    executor.post(1, TimerPriority::Normal, job(1));
+    std::thread opener([&]() {
+      std::this_thread::sleep_for(milliseconds(30));
+      gate.open = true;
+    });
+    const auto start = steady_clock::now();
+    executor.post(2, TimerPriority::Normal, job(2));  // 阻塞到工作线程取走 1
+    REQUIRE(steady_clock::now() - start >= milliseconds(20));
+    opener.join();
+    std::this_thread::sleep_for(milliseconds(20));
+    REQUIRE(ran == 2);
+    REQUIRE(executor.stats().blocked == 1);
+  }
+
+  SECTION("stop drops queued jobs")
+  {
+    TimerExecutor executor(1, 4);
+    executor.post(0, TimerPriority::Normal, gate.job());
+    gate.wait_entered();
+    executor.post(1, TimerPriority::Normal, job(1));
+    gate.open = true;
+    executor.stop();
+    REQUIRE(ran + dropped == 1);
+    executor.post(2, TimerPriority::Normal, job(2));
+    REQUIRE(ran + dropped == 2);
+  }
+}
+
+TEST_CASE("TimerScheduler dispatches to an executor and keeps the period", "[TimerExecutor]")
+{
+  TimerExecutor executor(4, 64);
+  std::atomic<int> runs{0};
+  std::atomic<int> concurrent{0};
+  std::atomic<int> max_concurrent{0};
+  auto slow = [&]() {
+    const int now = ++concurrent;
+    int seen = max_concurrent;
+    while (now > seen && !max_concurrent.compare_exchange_weak(seen, now))
+    {
+    }
+    ++runs;
+    std::this_thread::sleep_for(milliseconds(35));
+    --concurrent;
+  };
+
+  SECTION("ticks overlap on the workers")
+  {
+    TimerScheduler scheduler;
+    scheduler.set_executor(&executor);
+    scheduler.schedule_every(milliseconds(10), slow);
+    std::this_thread::sleep_for(milliseconds(105));
+    scheduler.stop();
+    REQUIRE(runs >= 8);  // 慢任务不影响周期
+    REQUIRE(max_concurrent >= 3);
+  }
+
+  SECTION("single-flight timers skip ticks instead of queueing them")
+  {
+    TimerScheduler scheduler;
+    scheduler.set_executor(&executor);
+    const TimerId id = scheduler.schedule_every(milliseconds(10), slow);
+    REQUIRE(scheduler.set_single_flight(id));
+    std::this_thread::sleep_for(milliseconds(105));
+    scheduler.stop();
+    REQUIRE(max_concurrent == 1);
+    REQUIRE(runs >= 2);
+    REQUIRE(runs <= 4);
+    REQUIRE(scheduler.stats().skipped >= 5);
+  }
+}
+
+TEST_CASE("TimerScheduler applies task results returned on an executor", "[TimerExecutor]")
+{
+  TimerExecutor executor(2, 64);
+  TimerScheduler scheduler;
+  scheduler.set_executor(&executor);
+  std::atomic<int> stopped{0};
+  std::atomic<int> once{0};
+  std::atomic<int> cancelled{0};
+
+  scheduler.schedule_every(milliseconds(10),
+                           [&]() { return ++stopped == 3 ? TimerAction::Stop : TimerAction::Continue; });
+  scheduler.schedule_after(milliseconds(10), [&]() { ++once; });
+  const TimerId id = scheduler.schedule_every(milliseconds(10), [&]() { ++cancelled; });
+  REQUIRE(scheduler.size() == 3);
+
+  std::this_thread::sleep_for(milliseconds(55));
+  REQUIRE(scheduler.cancel(id));
+  const int at_cancel = cancelled;
+  std::this_thread::sleep_for(milliseconds(50));
+
+  REQUIRE(stopped == 3);
+  REQUIRE(once == 1);
+  REQUIRE(cancelled <= at_cancel + 1);
+  REQUIRE(scheduler.size() == 0);
+}
@@ -0,0 +1,126 @@
+#include <simple_timer/timer_loop.h>
+
+#include <catch.hpp>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::chrono;
+
+TEST_CASE("TimerLoop runs due timers only when polled", "[TimerLoop]")
+{
+  TimerLoop loop;
+  std::vector<int> order;
+  REQUIRE(loop.next_deadline() == TimerLoop::time_point::max());
+  REQUIRE(loop.timeout_ms(TimerLoop::clock::now()) == -1);
+
+  loop.schedule_after(milliseconds(20), [&]() { order.push_back(2); });
+  loop.schedule_after(milliseconds(10), [&]() { order.push_back(1); });
+  const auto first = loop.next_deadline();
+  REQUIRE(loop.size() == 2);
+  REQUIRE(loop.timeout_ms(first - microseconds(9500)) == 10);  // 向上取整, 不会提前醒来
+  REQUIRE(loop.timeout_ms(first) == 0);
+
+  REQUIRE(loop.poll(first - nanoseconds(1)) == first);
+  REQUIRE(order.empty());
+  const auto second = loop.poll(first);
+  REQUIRE(order == std::vector<int>{1});
+  loop.poll(second + seconds(1));
+  REQUIRE(order == std::vector<int>{1, 2});
+  REQUIRE(loop.empty());
+  REQUIRE(loop.poll(second + seconds(2)) == TimerLoop::time_point::max());
+}
+
+TEST_CASE("TimerLoop periodic deadlines do not drift with poll latency", "[TimerLoop]")
+{
+  TimerLoop loop;
+  int runs = 0;
+  loop.schedule_every(milliseconds(10), [&]() { ++runs; });
+  const auto start = loop.next_deadline();
+
+  auto next = start;
+  for (int i = 0; i < 100; ++i)
+  {
+    next = loop.poll(next + milliseconds(3));  // 每次都晚 3ms 才轮询
+  }
+  REQUIRE(runs == 100);
+  REQUIRE(next == start + milliseconds(10) * 100);
+
+  // 落后多个周期时每次 poll 只补一次, poll 总会返回
+  REQUIRE(loop.poll(next + milliseconds(35)) == next + milliseconds(10));
+  REQUIRE(runs == 101);
+}
+
+TEST_CASE("TimerLoop tasks can reschedule and cancel timers from inside poll", "[TimerLoop]")
+{
+  TimerLoop loop;
+  const auto now = TimerLoop::clock::now();
+  int a = 0;
+  int b = 0;
+  int spawned = 0;
+  TimerId id_b = 0;
+  const TimerId id_a = loop.schedule_at(now, [&]() -> TimerNext {
+    ++a;
+    loop.cancel(id_b);                            // 同一批次中稍后的定时器
+    loop.schedule_at(now, [&]() { ++spawned; });  // 已到期, 但等下一次 poll
+    return a < 3 ? TimerNext(milliseconds(5)) : TimerNext(TimerAction::Stop);
+  });
+  id_b = loop.schedule_at(now, [&]() { ++b; });
+
+  loop.poll(now);
+  REQUIRE(a == 1);
+  REQUIRE(b == 0);
+  REQUIRE(spawned == 0);
+  REQUIRE(loop.size() == 2);
+  REQUIRE(loop.next_deadline() == now);  // 新定时器已到期
+
+  loop.poll(now);
+  REQUIRE(spawned == 1);
+  REQUIRE(loop.next_deadline() == now + milliseconds(5));  // 延迟从传入的 now 计算
+  loop.poll(now + milliseconds(5));
+  loop.poll(now + milliseconds(10));
+  REQUIRE(a == 3);
+  REQUIRE(spawned == 2);
+  loop.poll(now + milliseconds(10));
+  REQUIRE(spawned == 3);
+  REQUIRE(loop.empty());
+  REQUIRE_FALSE(loop.cancel(id_a));
+
+  TimerId self = 0;
+  int ticks = 0;
+  self = loop.schedule_every(milliseconds(1), [&]() {
+    ++ticks;
+    REQUIRE(loop.cancel(self));  // 取消自己: 本次执行完毕后不再入队
+    REQUIRE(loop.empty());
+  });
+  const auto due = loop.next_deadline();
+  loop.poll(due);
+  loop.poll(due + milliseconds(1));
+  REQUIRE(ticks == 1);
+  REQUIRE(loop.next_deadline() == TimerLoop::time_point::max());
+}
+
+#ifndef SIMPLE_TIMER_NO_EXCEPTIONS
+TEST_CASE("TimerLoop passes task exceptions to the error handler", "[TimerLoop]")
+{
+  TimerLoop loop;
+  std::uint32_t consecutive = 0;
+  loop.set_error_handler([&](const TimerError &err) -> TimerNext {
+    consecutive = err.consecutive;
+    return err.consecutive < 2 ? TimerNext(TimerAction::Continue) : TimerNext(TimerAction::Stop);
+  });
+  int runs = 0;
+  loop.schedule_every(milliseconds(1), [&]() {
+    ++runs;
+    throw std::runtime_error("boom");
+  });
+  const auto now = loop.next_deadline();
+  loop.poll(now);
+  loop.poll(now + milliseconds(1));
+  loop.poll(now + milliseconds(2));
+  REQUIRE(runs == 2);
+  REQUIRE(consecutive == 2);
+  REQUIRE(loop.empty());
+}
+#endif
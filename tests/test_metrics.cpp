@@ -0,0 +1,122 @@
+#include <simple_timer/timer_registry.h>
+
+#include <catch.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+TEST_CASE("TimerHistogram buckets and quantiles", "[TimerMetrics]")
+{
+  TimerHistogram h;
+  REQUIRE(h.quantile(0.5) == 0.0);
+  h.record(nanoseconds(-5));    // 负值记为 0
+  h.record(microseconds(3));    // [2, 4) us
+  h.record(microseconds(100));  // [64, 128) us
+  h.record(milliseconds(5));    // [4096, 8192) us
+  h.record(seconds(100));       // 最后一个桶
+  REQUIRE(h.count() == 5);
+  REQUIRE(h.bucket(0) == 1);
+  REQUIRE(h.bucket(2) == 1);
+  REQUIRE(h.bucket(7) == 1);
+  REQUIRE(h.bucket(13) == 1);
+  REQUIRE(h.bucket(TimerHistogram::kBuckets - 1) == 1);
+  REQUIRE(h.quantile(0.5) == Approx(128e-6));
+  REQUIRE(h.quantile(0.8) == Approx(8192e-6));
+  REQUIRE(h.quantile(1.0) == Approx(TimerHistogram::upper_bound(TimerHistogram::kBuckets - 2)));
+}
+
+TEST_CASE("TimerRegistry renders OpenMetrics text into a caller buffer", "[TimerMetrics]")
+{
+  SimpleTimer fast(milliseconds(10));
+  SimpleTimer idle(seconds(10));
+  TimerRegistry registry;
+  REQUIRE(registry.add("fast", fast));
+  REQUIRE(registry.add("say \"hi\"", idle));
+  REQUIRE_FALSE(registry.add("fast", idle));  // 名称重复
+  REQUIRE_FALSE(registry.add("other", fast));  // 定时器重复
+
+  fast.start([]() {});
+  std::this_thread::sleep_for(milliseconds(55));
+  fast.pause();
+
+  const std::size_t needed = registry.render(nullptr, 0);
+  std::vector<char> buf(needed + 1);
+  REQUIRE(registry.render(buf.data(), buf.size()) == needed);
+  const std::string text(buf.data());
+  REQUIRE(text.size() == needed);
+
+  REQUIRE(text.find("simple_timer_fires_total{timer=\"fast\"} ") != std::string::npos);
+  REQUIRE(text.find("simple_timer_fires_total{timer=\"fast\"} 0") == std::string::npos);
+  REQUIRE(text.find("simple_timer_fires_total{timer=\"say \\\"hi\\\"\"} 0\n") != std::string::npos);
+  REQUIRE(text.find("simple_timer_lateness_seconds{timer=\"fast\",quantile=\"0.99\"}") != std::string::npos);
+  REQUIRE(text.find("simple_timer_execution_seconds_bucket{timer=\"fast\",le=\"+Inf\"}") != std::string::npos);
+  REQUIRE(text.find("simple_timer_overruns_total{timer=\"fast\"} 0\n") != std::string::npos);
+  REQUIRE(text.find("simple_timer_exceptions_total{timer=\"fast\"} 0\n") != std::string::npos);
+  REQUIRE(text.find("simple_timer_state{timer=\"fast\",simple_timer_state=\"paused\"} 1\n") != std::string::npos);
+  REQUIRE(text.find("simple_timer_state{timer=\"say \\\"hi\\\"\",simple_timer_state=\"stopped\"} 1\n") !=
+          std::string::npos);
+  REQUIRE(text.find("# TYPE simple_timer_state stateset") != std::string::npos);
+  REQUIRE(text.compare(text.size() - 6, 6, "# EOF\n") == 0);
+
+  char small[64];
+  REQUIRE(registry.render(small, sizeof(small)) >= needed);  // 截断时返回完整长度
+  REQUIRE(std::string(small).size() == sizeof(small) - 1);
+
+  REQUIRE(registry.remove(idle));
+  REQUIRE_FALSE(registry.remove(idle));
+  REQUIRE(registry.size() == 1);
+  REQUIRE(registry.remove(fast));
+}
+
+TEST_CASE("TimerRegistry renders _count consistent with the +Inf bucket", "[TimerMetrics]")
+{
+  SimpleTimer timer(microseconds(20));
+  TimerRegistry registry;
+  REQUIRE(registry.add("busy", timer));
+  timer.start([]() {});
+
+  auto value = [](const std::string &text, const std::string &series) {
+    const std::size_t at = text.find(series);
+    return at == std::string::npos ? ~0ull : std::strtoull(text.c_str() + at + series.size(), nullptr, 10);
+  };
+  std::vector<char> buf(1 << 16);
+  bool consistent = true;
+  for (int i = 0; i < 2000 && consistent; ++i)  // 与定时器线程的写入并发渲染
+  {
+    registry.render(buf.data(), buf.size());
+    const std::string text(buf.data());
+    consistent = value(text, "simple_timer_execution_seconds_bucket{timer=\"busy\",le=\"+Inf\"} ") ==
+                 value(text, "simple_timer_execution_seconds_count{timer=\"busy\"} ");
+  }
+  timer.stop();
+  REQUIRE(registry.remove(timer));
+  REQUIRE(consistent);
+}
+
+TEST_CASE("TimerRegistry writes a node_exporter textfile", "[TimerMetrics]")
+{
+  SimpleTimer timer(milliseconds(10));
+  TimerRegistry registry;
+  registry.add("job", timer);
+
+  const std::string path = "simple_timer_test.prom";
+  REQUIRE(registry.write_textfile(path));
+  std::ifstream in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  const std::string text = ss.str();
+  std::remove(path.c_str());
+
+  REQUIRE(text.find("# TYPE simple_timer_fires_total counter") != std::string::npos);
+  REQUIRE(text.find("# TYPE simple_timer_state gauge") != std::string::npos);
+  REQUIRE(text.find("# EOF") == std::string::npos);
+  REQUIRE(text.find("simple_timer_state{timer=\"job\",simple_timer_state=\"stopped\"} 1\n") != std::string::npos);
+  registry.remove(timer);
+}
@@ -0,0 +1,71 @@
+#include <simple_timer/rate_limiter.h>
+
+#include <atomic>
+#include <catch.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+TEST_CASE("RateLimiter allows a burst then refills lazily", "[RateLimiter]")
+{
+  RateLimiter limiter(100.0, 5);  // 每 10ms 一个令牌, 容量 5
+
+  REQUIRE(limiter.available() == 5);
+  for (int i = 0; i < 5; ++i)
+  {
+    REQUIRE(limiter.try_acquire());
+  }
+  REQUIRE_FALSE(limiter.try_acquire());   // 桶已空
+  REQUIRE_FALSE(limiter.try_acquire(6));  // 超过容量永远不会成功
+
+  std::this_thread::sleep_for(milliseconds(35));
+  REQUIRE(limiter.available() >= 3);  // 按经过的时间懒惰补充
+  REQUIRE(limiter.try_acquire(3));
+}
+
+TEST_CASE("RateLimiter try_acquire is exact under contention", "[RateLimiter]")
+{
+  RateLimiter limiter(1.0, 100);  // 补充极慢, 只有初始的 100 个令牌
+  std::atomic<int> granted{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 100; ++i)
+      {
+        if (limiter.try_acquire())
+        {
+          granted++;
+        }
+      }
+    });
+  }
+  for (auto &t : threads)
+  {
+    t.join();
+  }
+  REQUIRE(granted == 100);
+}
+
+TEST_CASE("RateLimiter wakes async waiters when tokens exist", "[RateLimiter]")
+{
+  TimerScheduler scheduler;
+  RateLimiter limiter(20.0, 1);  // 每 50ms 一个令牌
+  std::atomic<int> done{0};
+
+  auto start = steady_clock::now();
+  REQUIRE(limiter.acquire_async(scheduler, 1, [&]() { done++; }) == 0);  // 令牌可用, 立即执行
+  REQUIRE(done == 1);
+
+  limiter.acquire_async(scheduler, 1, [&]() { done++; });  // 约 50ms 后
+  limiter.acquire_async(scheduler, 1, [&]() { done++; });  // 约 100ms 后
+  std::this_thread::sleep_for(milliseconds(30));
+  REQUIRE(done == 1);
+  std::this_thread::sleep_for(milliseconds(120));
+  REQUIRE(done == 3);
+
+  limiter.acquire();  // 阻塞等待下一个令牌 (约 150ms 处)
+  REQUIRE(steady_clock::now() - start >= milliseconds(140));
+}
@@ -0,0 +1,119 @@
+#include <simple_timer/retry_timer.h>
+
+#include <atomic>
+#include <catch.hpp>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::chrono;
+
+TEST_CASE("RetryOptions computes capped exponential delays", "[RetryTimer]")
+{
+  RetryOptions opt;
+  opt.base_delay = milliseconds(100);
+  opt.multiplier = 2.0;
+  opt.max_delay = milliseconds(1000);
+  opt.jitter = RetryOptions::Jitter::None;
+  std::mt19937_64 rng(42);
+
+  REQUIRE(opt.delay(1, steady_clock::duration::zero(), rng) == milliseconds(100));
+  REQUIRE(opt.delay(2, steady_clock::duration::zero(), rng) == milliseconds(200));
+  REQUIRE(opt.delay(4, steady_clock::duration::zero(), rng) == milliseconds(800));
+  REQUIRE(opt.delay(10, steady_clock::duration::zero(), rng) == milliseconds(1000));  // 上限
+  REQUIRE(opt.delay(4000000000u, steady_clock::duration::zero(), rng) == milliseconds(1000));
+  opt.multiplier = 0.5;
+  REQUIRE(opt.delay(10, steady_clock::duration::zero(), rng) == milliseconds(100));  // 小于 1 的倍数按 1 处理
+  opt.multiplier = 2.0;
+
+  opt.jitter = RetryOptions::Jitter::Full;
+  for (int i = 0; i < 100; ++i)
+  {
+    auto d = opt.delay(3, steady_clock::duration::zero(), rng);
+    REQUIRE(d >= steady_clock::duration::zero());
+    REQUIRE(d <= milliseconds(400));
+  }
+
+  opt.jitter = RetryOptions::Jitter::Decorrelated;
+  steady_clock::duration prev = steady_clock::duration::zero();
+  for (int i = 0; i < 100; ++i)
+  {
+    auto d = opt.delay(1, prev, rng);
+    REQUIRE(d >= milliseconds(100));
+    REQUIRE(d <= std::max<steady_clock::duration>(milliseconds(100), prev * 3));
+    REQUIRE(d <= milliseconds(1000));
+    prev = d;
+  }
+}
+
+TEST_CASE("RetryTimer retries until success and resets", "[RetryTimer]")
+{
+  TimerScheduler scheduler;
+  RetryOptions opt;
+  opt.base_delay = milliseconds(10);
+  opt.jitter = RetryOptions::Jitter::None;
+  std::atomic<int> calls{0};
+
+  RetryTimer retry(scheduler, opt, [&]() { return ++calls == 3; });  // 前两次失败
+  retry.start();
+
+  std::this_thread::sleep_for(milliseconds(150));  // 0ms, 10ms, 30ms
+  REQUIRE(calls == 3);
+  REQUIRE(retry.attempts() == 0);  // 成功后清零
+  REQUIRE(scheduler.size() == 0);  // 成功后不再占用调度节点
+}
+
+TEST_CASE("RetryTimer gives up after max attempts", "[RetryTimer]")
+{
+  TimerScheduler scheduler;
+  RetryOptions opt;
+  opt.base_delay = milliseconds(5);
+  opt.jitter = RetryOptions::Jitter::None;
+  opt.max_attempts = 4;
+  std::atomic<int> calls{0};
+  std::atomic<int> gave_up{0};
+
+  RetryTimer retry(scheduler, opt, [&]() -> bool {
+    calls++;
+    throw std::runtime_error("connection refused");  // 异常视为失败
+  });
+  retry.on_give_up([&]() { gave_up++; });
+  retry.start();
+
+  std::this_thread::sleep_for(milliseconds(200));
+  REQUIRE(calls == 4);
+  REQUIRE(gave_up == 1);
+  REQUIRE(retry.attempts() == 4);
+  REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE("RetryTimer restart ignores the attempt still running", "[RetryTimer]")
+{
+  TimerScheduler scheduler;
+  RetryOptions opt;
+  opt.base_delay = milliseconds(5);
+  opt.jitter = RetryOptions::Jitter::None;
+  opt.max_attempts = 1;
+  std::atomic<int> calls{0};
+  std::atomic<int> gave_up{0};
+
+  RetryTimer retry(scheduler, opt, [&]() {
+    if (++calls == 1)
+    {
+      std::this_thread::sleep_for(milliseconds(50));  // 执行期间被重新开始
+      return false;
+    }
+    return true;
+  });
+  retry.on_give_up([&]() { gave_up++; });
+  retry.start();
+  std::this_thread::sleep_for(milliseconds(20));
+  retry.start();
+
+  std::this_thread::sleep_for(milliseconds(100));
+  REQUIRE(calls == 2);
+  REQUIRE(gave_up == 0);  // 旧序列的失败不计入新序列, 也不会触发放弃
+  REQUIRE(retry.attempts() == 0);
+  REQUIRE(scheduler.size() == 0);
+}
@@ -0,0 +1,350 @@
+#include <simple_timer/timer_scheduler.h>
+
+#include <atomic>
+#include <catch.hpp>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+TEMPLATE_TEST_CASE("TimerScheduler runs one-shot timers in deadline order", "[TimerScheduler]", TimerHeap,
+                   FlatTimerQueue, LadderTimerQueue)
+{
+  BasicTimerScheduler<TestType> scheduler;
+  std::mutex mtx;
+  std::vector<int> order;
+  auto record = [&](int n) {
+    std::lock_guard<std::mutex> lock(mtx);
+    order.push_back(n);
+  };
+
+  scheduler.schedule_after(milliseconds(60), [&]() { record(3); });
+  scheduler.schedule_after(milliseconds(20), [&]() { record(1); });
+  scheduler.schedule_after(milliseconds(40), [&]() { record(2); });
+
+  std::this_thread::sleep_for(milliseconds(200));
+
+  std::lock_guard<std::mutex> lock(mtx);
+  REQUIRE(order == std::vector<int>{1, 2, 3});
+  REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE("TimerScheduler periodic timer and cancel", "[TimerScheduler]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> counter{0};
+
+  TimerId id = scheduler.schedule_every(milliseconds(20), [&]() { counter++; });
+  REQUIRE(id != 0);
+
+  std::this_thread::sleep_for(milliseconds(150));
+  REQUIRE(scheduler.cancel(id));
+  REQUIRE_FALSE(scheduler.cancel(id));  // 重复取消返回 false
+  int stopped = counter.load();
+
+  std::this_thread::sleep_for(milliseconds(100));
+
+  REQUIRE(stopped >= 3);
+  REQUIRE(counter <= stopped + 1);  // 取消时可能正在执行一次
+  REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE("TimerScheduler honors TimerNext results and cancel from the task", "[TimerScheduler]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> stopped_by_result{0};
+  std::atomic<int> cancelled_itself{0};
+  std::atomic<TimerId> self{0};
+
+  scheduler.schedule_every(milliseconds(10), [&]() {
+    return ++stopped_by_result == 3 ? TimerAction::Stop : TimerAction::Continue;
+  });
+  self = scheduler.schedule_every(milliseconds(10), [&]() {
+    if (++cancelled_itself == 2)
+    {
+      scheduler.cancel(self);
+    }
+  });
+
+  std::this_thread::sleep_for(milliseconds(200));
+
+  REQUIRE(stopped_by_result == 3);
+  REQUIRE(cancelled_itself == 2);
+  REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE("TimerScheduler error handler stops only the failing timer", "[TimerScheduler]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> good{0};
+  std::atomic<int> bad{0};
+
+  scheduler.set_error_handler(TimerErrorPolicy::stop());
+  scheduler.schedule_every(milliseconds(10), [&]() { good++; });
+  scheduler.schedule_every(milliseconds(10), [&]() {
+    bad++;
+    throw std::runtime_error("boom");
+  });
+
+  std::this_thread::sleep_for(milliseconds(150));
+
+  REQUIRE(bad == 1);
+  REQUIRE(good >= 3);
+  REQUIRE(scheduler.size() == 1);
+}
+
+TEST_CASE("TimerScheduler schedules cron timers by their next deadline", "[TimerScheduler]")
+{
+  TimerScheduler scheduler;
+
+  REQUIRE(scheduler.schedule_cron(CronExpr("not a cron"), []() {}) == 0);
+  REQUIRE(scheduler.schedule_cron(CronExpr("0 0 30 2 *"), []() {}) == 0);  // 永不触发
+
+  // 大量 cron 条目只占用队列节点, 不会提前触发
+  std::atomic<int> fired{0};
+  for (int i = 0; i < 10000; ++i)
+  {
+    REQUIRE(scheduler.schedule_cron(CronExpr("0 0 1 1 *"), [&]() { fired++; }) != 0);
+  }
+  REQUIRE(scheduler.size() == 10000);
+  std::this_thread::sleep_for(milliseconds(50));
+  REQUIRE(fired == 0);
+}
+
+TEST_CASE("TimerScheduler dispatches timers due together as one batch", "[TimerScheduler]")
+{
+  TimerScheduler scheduler;
+  std::mutex mutex;
+  std::vector<std::size_t> batches;
+  std::atomic<int> fired{0};
+  scheduler.on_expired([&](TimerIdSpan ids) {
+    std::lock_guard<std::mutex> lock(mutex);
+    batches.push_back(ids.size);
+  });
+
+  scheduler.schedule_after(milliseconds(0), []() { std::this_thread::sleep_for(milliseconds(100)); });  // 阻塞调度线程
+  std::this_thread::sleep_for(milliseconds(20));
+  for (int i = 0; i < 500; ++i)
+  {
+    scheduler.schedule_after(milliseconds(10), [&]() { ++fired; });
+  }
+
+  std::this_thread::sleep_for(milliseconds(200));
+  REQUIRE(fired == 500);
+  std::lock_guard<std::mutex> lock(mutex);
+  REQUIRE(batches.size() == 2);
+  REQUIRE(batches[0] == 1);
+  REQUIRE(batches[1] == 500);  // 阻塞期间全部到期, 一次取出
+}
+
+TEST_CASE("TimerScheduler lazy cancellation leaves tombstones and compacts them", "[TimerScheduler]")
+{
+  TimerScheduler scheduler;
+  scheduler.set_cancel_mode(TimerCancelMode::Lazy, 0.5);
+  std::vector<TimerId> ids;
+  for (int i = 0; i < 200; ++i)
+  {
+    ids.push_back(scheduler.schedule_after(hours(1), []() {}));
+  }
+  for (int i = 0; i < 50; ++i)
+  {
+    REQUIRE(scheduler.cancel(ids[i]));
+  }
+  REQUIRE_FALSE(scheduler.cancel(ids[0]));  // 墓碑不能重复取消
+  TimerSchedulerStats stats = scheduler.stats();
+  REQUIRE(stats.tombstones == 50);
+  REQUIRE(stats.timers == 150);
+  REQUIRE(scheduler.size() == 150);
+
+  for (int i = 50; i < 101; ++i)
+  {
+    scheduler.cancel(ids[i]);  // 第 101 个墓碑超过队列的一半, 触发压缩
+  }
+  stats = scheduler.stats();
+  REQUIRE(stats.compactions == 1);
+  REQUIRE(stats.tombstones == 0);
+  REQUIRE(stats.timers == 99);
+
+  std::atomic<int> fired{0};
+  std::vector<TimerId> soon;
+  for (int i = 0; i < 5; ++i)
+  {
+    soon.push_back(scheduler.schedule_after(milliseconds(20), [&]() { ++fired; }));
+  }
+  scheduler.cancel(soon[1]);
+  scheduler.cancel(soon[3]);
+  std::this_thread::sleep_for(milliseconds(100));
+  REQUIRE(fired == 3);
+  stats = scheduler.stats();
+  REQUIRE(stats.tombstones_skipped == 2);  // 到期时跳过
+  REQUIRE(stats.tombstones == 0);
+  REQUIRE(stats.timers == 99);
+}
+
+TEST_CASE("TimerScheduler runs higher priorities first within a batch", "[TimerScheduler]")
+{
+  TimerScheduler scheduler;
+  std::mutex mtx;
+  std::vector<int> order;
+  auto record = [&](int n) {
+    std::lock_guard<std::mutex> lock(mtx);
+    order.push_back(n);
+  };
+
+  scheduler.schedule_after(milliseconds(0), []() { std::this_thread::sleep_for(milliseconds(60)); });  // 阻塞调度线程
+  std::this_thread::sleep_for(milliseconds(10));
+  scheduler.schedule_after(milliseconds(5), [&]() { record(0); }, TimerPriority::Low);
+  scheduler.schedule_after(milliseconds(10), [&]() { record(1); });
+  scheduler.schedule_after(milliseconds(15), [&]() { record(2); }, TimerPriority::High);
+  scheduler.schedule_after(milliseconds(20), [&]() { record(3); }, TimerPriority::Critical);
+  scheduler.schedule_after(milliseconds(25), [&]() { record(10); }, TimerPriority::Low);
+
+  std::this_thread::sleep_for(milliseconds(150));
+  std::lock_guard<std::mutex> lock(mtx);
+  REQUIRE(order == std::vector<int>{3, 2, 1, 0, 10});  // 同优先级内仍按到期顺序
+}
+
+TEMPLATE_TEST_CASE("TimerScheduler sheds low priorities under overload", "[TimerScheduler]", std::chrono::steady_clock,
+                   CachedClock<>)
+{
+  BasicTimerScheduler<TimerHeap, TestType> scheduler;
+  TimerOverloadPolicy policy;
+  policy.max_lag = milliseconds(20);
+  policy.protect = TimerPriority::Normal;
+  std::atomic<int> normal{0};
+  std::atomic<int> low{0};
+  auto lead = []() { std::this_thread::sleep_for(milliseconds(15)); };
+  auto block = []() { std::this_thread::sleep_for(milliseconds(60)); };
+
+  SECTION("drop")
+  {
+    policy.action = TimerOverloadPolicy::Action::Drop;
+    scheduler.set_overload_policy(policy);
+    scheduler.schedule_after(milliseconds(0), lead);  // 之后的定时器在同一批到期, 批次时间只落后约 10ms
+    scheduler.schedule_after(milliseconds(5), block, TimerPriority::High);
+    scheduler.schedule_after(milliseconds(5), [&]() { ++normal; });
+    scheduler.schedule_after(milliseconds(5), [&]() { ++low; }, TimerPriority::Low);
+    std::this_thread::sleep_for(milliseconds(140));
+    REQUIRE(normal == 1);
+    REQUIRE(low == 0);
+    REQUIRE(scheduler.stats().dropped == 1);
+    REQUIRE(scheduler.size() == 0);  // 被丢弃的单次定时器已删除
+  }
+
+  SECTION("delay")
+  {
+    policy.action = TimerOverloadPolicy::Action::Delay;
+    scheduler.set_overload_policy(policy);
+    scheduler.schedule_after(milliseconds(0), lead);
+    scheduler.schedule_after(milliseconds(5), block, TimerPriority::High);
+    scheduler.schedule_after(milliseconds(5), [&]() { ++low; }, TimerPriority::Low);
+    std::this_thread::sleep_for(milliseconds(140));
+    REQUIRE(low == 1);  // 推迟到下一批后执行
+    REQUIRE(scheduler.stats().delayed == 1);
+  }
+
+  SECTION("delay keeps the periodic phase")
+  {
+    policy.action = TimerOverloadPolicy::Action::Delay;
+    scheduler.set_overload_policy(policy);
+    const steady_clock::time_point start = steady_clock::now();
+    std::atomic<steady_clock::time_point::rep> first{0};
+    scheduler.schedule_after(milliseconds(45), []() { std::this_thread::sleep_for(milliseconds(80)); },
+                             TimerPriority::High);
+    scheduler.schedule_every(milliseconds(50), [&]() {
+      steady_clock::time_point::rep expected = 0;
+      first.compare_exchange_strong(expected, (steady_clock::now() - start).count());
+      ++low;
+    }, TimerPriority::Low);
+    std::this_thread::sleep_for(milliseconds(180));
+    REQUIRE(scheduler.stats().delayed == 2);  // 50ms 与 100ms 两个周期落后过多, 150ms 的周期按时执行
+    REQUIRE(steady_clock::duration(first.load()) >= milliseconds(145));
+    REQUIRE(low >= 1);
+  }
+}
+
+TEST_CASE("TimerScheduler pauses and resumes single timers", "[TimerScheduler]")
+{
+  TimerScheduler scheduler;
+  std::atomic<int> paused{0};
+  std::atomic<int> other{0};
+  std::atomic<int> once{0};
+  TimerId id = scheduler.schedule_every(milliseconds(20), [&]() { ++paused; });
+  scheduler.schedule_every(milliseconds(20), [&]() { ++other; });
+  TimerId later = scheduler.schedule_after(milliseconds(120), [&]() { ++once; });
+
+  std::this_thread::sleep_for(milliseconds(50));
+  REQUIRE(scheduler.pause(id));
+  REQUIRE_FALSE(scheduler.pause(id));  // 已暂停
+  REQUIRE(scheduler.pause(later));
+  int frozen = paused.load();
+  std::this_thread::sleep_for(milliseconds(100));
+  REQUIRE(paused <= frozen + 1);  // 暂停时可能正在执行一次
+  REQUIRE(once == 0);             // 剩余时间被保留, 暂停期间不走时
+  REQUIRE(other >= 5);
+  REQUIRE(scheduler.size() == 3);
+
+  frozen = paused.load();
+  REQUIRE(scheduler.resume(id));
+  REQUIRE(scheduler.resume(later));
+  REQUIRE_FALSE(scheduler.resume(later));
+  std::this_thread::sleep_for(milliseconds(30));
+  REQUIRE(once == 0);  // 暂停时还剩约 70ms
+  std::this_thread::sleep_for(milliseconds(80));
+  REQUIRE(once == 1);
+  REQUIRE(paused >= frozen + 2);
+
+  REQUIRE(scheduler.pause(id));
+  REQUIRE(scheduler.cancel(id));  // 取消暂停中的定时器
+  REQUIRE_FALSE(scheduler.resume(id));
+  REQUIRE(scheduler.size() == 1);
+}
+
+TEMPLATE_TEST_CASE("TimerScheduler runs on every clock source", "[TimerScheduler]", std::chrono::steady_clock,
+                   CoarseSteadyClock, TscClock, CachedClock<>)
+{
+  BasicTimerScheduler<TimerHeap, TestType> scheduler;
+  std::atomic<int> periodic{0};
+  std::atomic<int> once{0};
+  scheduler.schedule_every(milliseconds(10), [&]() { ++periodic; });
+  scheduler.schedule_after(milliseconds(30), [&]() { ++once; });
+
+  std::this_thread::sleep_for(milliseconds(125));
+  REQUIRE(once == 1);
+  REQUIRE(periodic >= 8);
+  REQUIRE(periodic <= 13);
+}
+
+TEST_CASE("TimerScheduler re-arms from a fresh time under CachedClock", "[TimerScheduler]")
+{
+  BasicTimerScheduler<TimerHeap, CachedClock<>> scheduler;
+  std::mutex mtx;
+  std::vector<steady_clock::time_point> runs;
+  scheduler.schedule_after(milliseconds(5), []() { std::this_thread::sleep_for(milliseconds(50)); });
+  scheduler.schedule_after(milliseconds(5), [&]() -> TimerNext {
+    std::lock_guard<std::mutex> lock(mtx);
+    runs.push_back(steady_clock::now());
+    return runs.size() < 2 ? TimerNext(milliseconds(30)) : TimerNext(TimerAction::Stop);
+  });  // 与慢任务同一批, 缓存的批次时间已落后约 50ms
+
+  std::this_thread::sleep_for(milliseconds(150));
+  std::lock_guard<std::mutex> lock(mtx);
+  REQUIRE(runs.size() == 2);
+  REQUIRE(runs[1] - runs[0] >= milliseconds(25));  // 从任务返回时计时, 而不是从批次开始
+}
+
+TEST_CASE("Clock sources share the steady_clock epoch", "[TimerClock]")
+{
+  auto abs = [](nanoseconds d) { return d < nanoseconds::zero() ? -d : d; };
+  const auto steady = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch());
+  REQUIRE(abs(TscClock::now().time_since_epoch() - steady) < milliseconds(5));
+  REQUIRE(abs(CoarseSteadyClock::now().time_since_epoch() - steady) < milliseconds(20));
+
+  REQUIRE(abs(CachedClock<>::now().time_since_epoch() - steady) < milliseconds(5));  // 未刷新的线程直接读时钟
+  const auto cached = CachedClock<>::refresh();
+  std::this_thread::sleep_for(milliseconds(5));
+  REQUIRE(CachedClock<>::now() == cached);  // 刷新过的线程读取缓存值
+}
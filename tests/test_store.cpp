@@ -0,0 +1,178 @@
+#include <simple_timer/timer_store.h>
+
+#include <catch.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace
+{
+/// @brief 测试用的存储文件, 析构时删除
+struct StoreFiles
+{
+  std::string path;
+  explicit StoreFiles(const std::string &p) : path(p)
+  {
+    clear();
+  }
+  ~StoreFiles()
+  {
+    clear();
+  }
+  void clear() const
+  {
+    std::remove((path + ".log").c_str());
+    std::remove((path + ".idx").c_str());
+  }
+};
+}  // namespace
+
+TEST_CASE("DurableTimerStore keeps timers across reopen until acknowledged", "[DurableTimerStore]")
+{
+  StoreFiles files("durable_ack");
+  const system_clock::time_point now = system_clock::now();
+  DurableTimerStore store;
+  REQUIRE(store.open(files.path));
+  const TimerId first = store.add(now + seconds(1), "order-1");
+  const TimerId second = store.add(now + seconds(2), "order-2");
+  const TimerId cancelled = store.add(now + seconds(3), "order-3");
+  REQUIRE(first != 0);
+  store.remove(cancelled);
+
+  store.close();
+  REQUIRE(store.open(files.path));
+  std::vector<std::string> fired;
+  REQUIRE(store.poll(now + seconds(5), [&](const DurableTimer &t) {
+    fired.push_back(t.payload);
+    return t.id == first;  // 只确认第一个
+  }) == 2);
+  REQUIRE(fired == std::vector<std::string>{"order-1", "order-2"});
+  REQUIRE(store.poll(now + seconds(5), [](const DurableTimer &) { return true; }) == 0);  // 本次运行中不重复投递
+
+  store.close();
+  REQUIRE(store.open(files.path));
+  fired.clear();
+  store.poll(now + seconds(5), [&](const DurableTimer &t) {
+    fired.push_back(t.payload);
+    return true;
+  });
+  REQUIRE(fired == std::vector<std::string>{"order-2"});  // 未确认的在恢复后再次投递
+  REQUIRE(store.add(now, "next") > second);               // id 不会重复
+}
+
+TEST_CASE("DurableTimerStore loads only the horizon window", "[DurableTimerStore]")
+{
+  StoreFiles files("durable_window");
+  DurableStoreOptions options;
+  options.horizon = seconds(60);
+  options.checkpoint_every = 300;
+  const system_clock::time_point now = system_clock::now();
+  DurableTimerStore store;
+  REQUIRE(store.open(files.path, options));
+  for (int i = 999; i >= 0; --i)
+  {
+    store.add(now + minutes(i), std::to_string(i));  // 每分钟一个, 共 1000 分钟
+  }
+  REQUIRE(store.stats().checkpoints == 0);  // add() 只追加日志
+  REQUIRE(store.poll(now - seconds(1), [](const DurableTimer &) { return true; }) == 0);
+  REQUIRE(store.stats().checkpoints == 1);  // 由 poll() 写索引
+
+  store.close();
+  REQUIRE(store.open(files.path, options));
+  DurableStoreStats stats = store.stats();
+  REQUIRE(stats.loaded <= 2);  // 只载入 60 秒窗口内的定时器
+  REQUIRE(stats.loaded + stats.deferred == 1000);
+
+  std::vector<int> fired;
+  for (int m = 0; m <= 1001; m += 7)
+  {
+    store.poll(now + minutes(m), [&](const DurableTimer &t) {
+      fired.push_back(std::stoi(t.payload));
+      return true;
+    });
+    REQUIRE(store.stats().loaded <= 3);
+  }
+  REQUIRE(fired.size() == 1000);
+  for (int i = 0; i < 1000; ++i)
+  {
+    REQUIRE(fired[i] == i);  // 按到期时间顺序
+  }
+  REQUIRE(store.next_deadline() == system_clock::time_point::max());
+}
+
+TEST_CASE("DurableTimerStore drops a torn record and compacts the log", "[DurableTimerStore]")
+{
+  StoreFiles files("durable_torn");
+  const system_clock::time_point now = system_clock::now();
+  DurableStoreOptions options;
+  options.checkpoint_every = 0;
+  DurableTimerStore store;
+  REQUIRE(store.open(files.path, options));
+  const std::string big(4096, 'x');
+  std::vector<TimerId> ids;
+  for (int i = 0; i < 600; ++i)
+  {
+    ids.push_back(store.add(now + hours(1), big));
+  }
+  const std::size_t used = store.stats().log_bytes;
+  store.close();
+
+  {
+    std::fstream log(files.path + ".log", std::ios::in | std::ios::out | std::ios::binary);
+    log.seekp(static_cast<std::streamoff>(used));
+    const char torn[12] = {40, 0, 0, 0, 1, 2, 3, 4, 1, 9, 9, 9};  // 写了一半的记录, 校验和不符
+    log.write(torn, sizeof(torn));
+  }
+  REQUIRE(store.open(files.path, options));
+  REQUIRE(store.stats().log_bytes == used);
+  REQUIRE(store.stats().deferred == 600);
+
+  for (std::size_t i = 0; i < ids.size(); ++i)
+  {
+    if (i % 10 != 0)
+    {
+      store.remove(ids[i]);
+    }
+  }
+  REQUIRE(store.checkpoint());
+  DurableStoreStats stats = store.stats();
+  REQUIRE(stats.compactions == 1);
+  REQUIRE(stats.log_bytes < used / 5);
+
+  store.close();
+  REQUIRE(store.open(files.path, options));
+  REQUIRE(store.poll(now + hours(2), [&](const DurableTimer &t) { return t.payload == big; }) == 60);
+  REQUIRE(store.stats().loaded == 0);
+}
+
+TEST_CASE("DurableTimerStore never reuses ids after a compaction without its index", "[DurableTimerStore]")
+{
+  StoreFiles files("durable_ids");
+  const system_clock::time_point now = system_clock::now();
+  DurableStoreOptions options;
+  options.checkpoint_every = 0;
+  DurableTimerStore store;
+  REQUIRE(store.open(files.path, options));
+  const std::string big(4096, 'x');
+  std::vector<TimerId> ids;
+  for (int i = 0; i < 600; ++i)
+  {
+    ids.push_back(store.add(now + hours(1), big));
+  }
+  for (std::size_t i = 60; i < ids.size(); ++i)
+  {
+    store.remove(ids[i]);  // 删除最新的定时器, 压缩后日志中只剩较小的 id
+  }
+  REQUIRE(store.checkpoint());
+  REQUIRE(store.stats().compactions == 1);
+  store.close();
+
+  std::remove((files.path + ".idx").c_str());  // 相当于在两次改名之间崩溃: 重放整个压缩后的日志
+  REQUIRE(store.open(files.path, options));
+  REQUIRE(store.stats().deferred == 60);
+  REQUIRE(store.add(now + hours(1), "next") > ids.back());
+}
@@ -4,7 +4,11 @@
 #include <atomic>
 #include <catch.hpp>
 #include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 using namespace std::chrono;
 
@@ -250,6 +254,95 @@ TEST_CASE("Multiple pause and resume toggles", "[SimpleTimer]")
   REQUIRE(counter > paused2);  // resume后继续执行
 }
 
+TEST_CASE("Concurrent pause and resume are linearizable", "[SimpleTimer]")
+{
+  SimpleTimer timer(milliseconds(1));
+  timer.start([]() {});
+  std::atomic<int> pauses{0};
+  std::atomic<int> resumes{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 20000; ++i)
+      {
+        pauses += timer.pause() ? 1 : 0;
+        resumes += timer.resume() ? 1 : 0;
+      }
+    });
+  }
+  for (std::thread &t : threads)
+  {
+    t.join();
+  }
+
+  // 成功的 pause 与 resume 严格交替: 每次转换恰好有一个调用者胜出
+  REQUIRE(pauses > 0);
+  REQUIRE((pauses == resumes || pauses == resumes + 1));
+  REQUIRE(timer.is_paused() == (pauses == resumes + 1));
+  if (timer.is_running())
+  {
+    REQUIRE(timer.pause());
+  }
+  REQUIRE_FALSE(timer.pause());
+  REQUIRE(timer.resume());
+  REQUIRE_FALSE(timer.resume());
+  timer.stop();
+  REQUIRE_FALSE(timer.pause());
+  REQUIRE_FALSE(timer.resume());
+}
+
+TEST_CASE("Resume wakes a parked timer promptly", "[SimpleTimer]")
+{
+  std::atomic<int> counter{0};
+  SimpleTimer timer(milliseconds(20));
+  timer.start([&]() { counter++; });
+  REQUIRE(timer.pause());                         // 不唤醒: 工作线程在原到期时间醒来后才停车
+  std::this_thread::sleep_for(milliseconds(60));     // 此时已停车
+  REQUIRE(counter == 0);
+
+  const auto resumed = steady_clock::now();
+  REQUIRE(timer.resume());
+  while (counter == 0 && steady_clock::now() - resumed < seconds(1))
+  {
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  timer.stop();
+  REQUIRE(counter >= 1);
+  REQUIRE(steady_clock::now() - resumed < milliseconds(200));  // 一个周期左右, 不会等到超时
+}
+
+TEST_CASE("Resume keeps an unobserved deadline and never catches up", "[SimpleTimer]")
+{
+  std::atomic<int> counter{0};
+  SimpleTimer timer(milliseconds(100));
+  timer.start([&]() { counter++; });
+
+  SECTION("resumed before the pending deadline")
+  {
+    std::this_thread::sleep_for(milliseconds(30));
+    REQUIRE(timer.pause());
+    std::this_thread::sleep_for(milliseconds(20));
+    REQUIRE(timer.resume());  // 工作线程仍在等待原到期时间 (约 100ms), 没有察觉这次暂停
+    std::this_thread::sleep_for(milliseconds(35));
+    REQUIRE(counter == 0);
+    std::this_thread::sleep_for(milliseconds(40));
+    REQUIRE(counter == 1);  // 仍按原到期时间触发, 不会推迟到恢复后一个周期 (约 150ms)
+  }
+
+  SECTION("paused for several intervals")
+  {
+    REQUIRE(timer.pause());
+    std::this_thread::sleep_for(milliseconds(350));  // 错过三个周期
+    REQUIRE(timer.resume());
+    std::this_thread::sleep_for(milliseconds(50));
+    REQUIRE(counter == 0);  // 不会立即触发, 也不补发错过的周期
+    std::this_thread::sleep_for(milliseconds(80));
+    REQUIRE(counter == 1);
+  }
+  timer.stop();
+}
+
 TEST_CASE("Multiple start replaces task", "[SimpleTimer]")
 {
   std::atomic<int> counter{0};
@@ -561,8 +654,275 @@ TEST_CASE("Restart while paused")
   REQUIRE(counter >= 1);
 }
 
+TEST_CASE("Task returning a duration reschedules itself", "[SimpleTimer]")
+{
+  std::atomic<int> counter{0};
+  SimpleTimer timer(milliseconds(100));  // 首次按 100ms 触发, 之后由返回值驱动
+
+  timer.start([&]() -> milliseconds {
+    counter++;
+    return milliseconds(20);
+  });
+
+  std::this_thread::sleep_for(milliseconds(300));
+  timer.stop();
+
+  REQUIRE(counter >= 5);  // 固定 100ms 间隔最多触发 3 次, 返回值生效后约 10 次
+}
+
+TEST_CASE("Task returning TimerAction::Stop stops the timer", "[SimpleTimer]")
+{
+  std::atomic<int> counter{0};
+  SimpleTimer timer(milliseconds(20));
+
+  timer.start([&]() {
+    return ++counter == 3 ? TimerAction::Stop : TimerAction::Continue;
+  });
+
+  std::this_thread::sleep_for(milliseconds(300));
+
+  REQUIRE(counter == 3);
+  REQUIRE(timer.is_stopped());
+}
+
+TEST_CASE("A bare RescheduleIn keeps the interval", "[SimpleTimer]")
+{
+  REQUIRE(TimerNext(TimerAction::RescheduleIn).action == TimerAction::Continue);  // 没有时长可用
+
+  std::atomic<int> counter{0};
+  SimpleTimer timer(milliseconds(20));
+  timer.start([&]() {
+    counter++;
+    return TimerAction::RescheduleIn;
+  });
+
+  std::this_thread::sleep_for(milliseconds(110));
+  timer.stop();
+
+  REQUIRE(counter >= 3);
+  REQUIRE(counter <= 7);  // 按 0 延迟处理时会连续执行上万次
+}
+
+TEST_CASE("One-shot timer can be re-armed by TimerNext", "[SimpleTimer]")
+{
+  std::atomic<int> counter{0};
+  SimpleTimer timer(milliseconds(20), true);  // one-shot 模式
+
+  timer.start([&]() -> TimerNext {
+    if (++counter < 3)
+    {
+      return milliseconds(10);  // RescheduleIn
+    }
+    return TimerAction::Continue;  // one-shot 下 Continue 即结束
+  });
+
+  std::this_thread::sleep_for(milliseconds(300));
+
+  REQUIRE(counter == 3);
+  REQUIRE(timer.is_stopped());
+}
+
+TEST_CASE("Error handler receives exception and timer id", "[SimpleTimer]")
+{
+  std::atomic<int> counter{0};
+  std::atomic<int> handled{0};
+  std::atomic<TimerId> seen_id{0};
+  SimpleTimer timer(milliseconds(20));
+
+  timer.set_error_handler([&](const TimerError &err) -> TimerNext {
+    seen_id = err.timer_id;
+    try
+    {
+      std::rethrow_exception(err.exception);
+    }
+    catch (const std::runtime_error &)
+    {
+      handled++;
+    }
+    return TimerAction::Continue;  // 出错后继续运行
+  });
+  timer.start([&]() {
+    counter++;
+    throw std::runtime_error("boom");
+  });
+
+  std::this_thread::sleep_for(milliseconds(200));
+  timer.stop();
+
+  REQUIRE(counter >= 3);
+  REQUIRE(handled == counter);
+  REQUIRE(seen_id == timer.id());
+  REQUIRE(timer.errors() == static_cast<std::uint64_t>(counter.load()));
+}
+
+TEST_CASE("Empty error handler only counts errors", "[SimpleTimer]")
+{
+  std::atomic<int> counter{0};
+  SimpleTimer timer(milliseconds(20));
+
+  timer.set_error_handler(nullptr);  // 仅计数, 不输出, 继续运行
+  timer.start([&]() {
+    if (++counter % 2 == 0)
+    {
+      throw 42;
+    }
+  });
+
+  std::this_thread::sleep_for(milliseconds(200));
+  timer.stop();
+
+  REQUIRE(counter >= 4);
+  REQUIRE(timer.errors() >= 2);
+}
+
+TEST_CASE("Backoff error policy delays retries", "[SimpleTimer]")
+{
+  std::atomic<int> counter{0};
+  SimpleTimer timer(milliseconds(10));
+
+  timer.set_error_handler(TimerErrorPolicy::backoff(milliseconds(100), seconds(1)));  // 100ms, 200ms, 400ms...
+  timer.start([&]() {
+    counter++;
+    throw std::runtime_error("always fails");
+  });
+
+  std::this_thread::sleep_for(milliseconds(250));
+  timer.stop();
+
+  REQUIRE(counter >= 2);  // 10ms 首次触发, 110ms 第二次
+  REQUIRE(counter <= 3);  // 若无退避, 10ms 间隔会触发 20 余次
+}
+
+TEST_CASE("Backoff error policy grows in closed form and honors the cap", "[SimpleTimer]")
+{
+  auto delay_after = [](const TimerErrorHandler &handler, std::uint32_t consecutive) {
+    return duration_cast<milliseconds>(handler(TimerError{nullptr, 1, steady_clock::now(), consecutive}).delay);
+  };
+  const TimerErrorHandler doubling = TimerErrorPolicy::backoff(milliseconds(100), seconds(1));
+  REQUIRE(delay_after(doubling, 1) == milliseconds(100));
+  REQUIRE(delay_after(doubling, 3) == milliseconds(400));
+  REQUIRE(delay_after(doubling, 5) == seconds(1));
+  REQUIRE(delay_after(doubling, 4000000000u) == seconds(1));  // 溢出后仍取上限
+
+  const TimerErrorHandler flat = TimerErrorPolicy::backoff(milliseconds(100), seconds(1), 1.0);
+  REQUIRE(delay_after(flat, 4000000000u) == milliseconds(100));  // 不随失败次数逐次计算
+  const TimerErrorHandler shrinking = TimerErrorPolicy::backoff(milliseconds(100), seconds(1), 0.5);
+  REQUIRE(delay_after(shrinking, 10) == milliseconds(100));  // 小于 1 的倍数按 1 处理
+}
+
+TEST_CASE("Stop error policy stops silently", "[SimpleTimer]")
+{
+  std::atomic<int> counter{0};
+  SimpleTimer timer(milliseconds(20));
+
+  timer.set_error_handler(TimerErrorPolicy::stop());
+  timer.start([&]() {
+    counter++;
+    throw std::runtime_error("stop");
+  });
+
+  std::this_thread::sleep_for(milliseconds(200));
+
+  REQUIRE(counter == 1);
+  REQUIRE(timer.is_stopped());
+  REQUIRE(timer.errors() == 1);
+}
+
+TEST_CASE("Wall-clock aligned timer fires on interval boundaries", "[SimpleTimer]")
+{
+  std::mutex mtx;
+  std::vector<int64_t> phases;  // 每次触发时墙钟相对于 (边界 + 偏移) 的毫秒数
+  SimpleTimer timer(milliseconds(100));
+
+  timer.align_to_wall_clock(milliseconds(30));  // 在 xx30ms 处触发
+  timer.start([&]() {
+    auto ms = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    std::lock_guard<std::mutex> lock(mtx);
+    phases.push_back((ms - 30) % 100);
+  });
+
+  std::this_thread::sleep_for(milliseconds(550));
+  timer.stop();
+
+  std::lock_guard<std::mutex> lock(mtx);
+  REQUIRE(phases.size() >= 4);
+  for (auto phase : phases)
+  {
+    REQUIRE(phase < 40);  // 容许调度延迟, 未对齐时相位是随机的
+  }
+}
+
+TEST_CASE("Wall-clock alignment never fires a boundary twice", "[SimpleTimer]")
+{
+  using simple_timer::detail::next_aligned_slot;
+
+  REQUIRE(next_aligned_slot(1050, 100, 0, INT64_MIN) == 11);   // 下一个边界 1100
+  REQUIRE(next_aligned_slot(1100, 100, 0, INT64_MIN) == 12);   // 恰好在边界上时取下一个
+  REQUIRE(next_aligned_slot(1050, 100, 30, INT64_MIN) == 11);  // 偏移 30: 边界 1130
+  REQUIRE(next_aligned_slot(-50, 100, 0, INT64_MIN) == 0);     // epoch 之前同样向下取整
+  REQUIRE(next_aligned_slot(1050, 100, 0, 11) == 12);          // 墙钟回拨: 边界 11 已触发, 不再重复
+  REQUIRE(next_aligned_slot(5050, 100, 0, 11) == 51);          // 墙钟前跳: 直接同步到新的边界, 不补跑
+}
+
 // TODO 在回调中调用 stop/restart 等情况的测试, 以确保不会死锁或崩溃(待修复)
 
+TEST_CASE("Absolute sleep wait strategy fires and reacts to control operations", "[SimpleTimer]")
+{
+  SimpleTimer timer(milliseconds(20));
+  timer.set_wait_strategy(TimerWaitStrategy::AbsoluteSleep);
+  std::atomic<int> counter{0};
+  timer.start([&]() { ++counter; });
+
+  std::this_thread::sleep_for(milliseconds(110));
+  REQUIRE(counter >= 4);
+  REQUIRE(counter <= 6);
+
+  timer.set_interval(seconds(10));  // 立即生效: 打断当前的睡眠
+  const int before = counter;
+  std::this_thread::sleep_for(milliseconds(50));
+  REQUIRE(counter == before);
+
+  timer.set_interval(milliseconds(10));
+  std::this_thread::sleep_for(milliseconds(55));
+  REQUIRE(counter > before);
+
+  timer.set_interval(seconds(10));
+  const auto start = steady_clock::now();
+  timer.stop();  // 不必等到 10 秒后
+  REQUIRE(steady_clock::now() - start < milliseconds(100));
+}
+
+TEST_CASE("Overrunning ticks are counted and reported", "[SimpleTimer]")
+{
+  SimpleTimer timer(milliseconds(20));
+  std::atomic<int> counter{0};
+  std::atomic<int> reports{0};
+  std::atomic<std::uint64_t> missed{0};
+  std::atomic<std::int64_t> lag_ms{0};
+  timer.on_overrun([&](steady_clock::duration lag, std::uint64_t missed_ticks) {
+    ++reports;
+    missed = missed_ticks;
+    lag_ms = duration_cast<milliseconds>(lag).count();
+  });
+  timer.start([&]() {
+    if (++counter == 2)
+    {
+      std::this_thread::sleep_for(milliseconds(50));  // 执行 2.5 个周期, 之后的追赶触发不算超时
+    }
+  });
+
+  std::this_thread::sleep_for(milliseconds(150));
+  timer.stop();
+
+  REQUIRE(timer.overruns() == 1);
+  REQUIRE(reports == 1);
+  REQUIRE(missed == 2);  // 落后约 30ms: 第 3、4 个触发点已到期
+  REQUIRE(lag_ms >= 30);
+  REQUIRE(lag_ms < 40);
+  REQUIRE(duration_cast<milliseconds>(timer.overrun_lag()).count() == lag_ms);
+  REQUIRE(counter >= 6);  // 追赶后恢复原来的节奏
+}
+
 TEST_CASE("Callback calls stop()", "[SimpleTimer]")
 {
   std::atomic<int> counter(0);
@@ -0,0 +1,136 @@
+#include <simple_timer/timer_queue.h>
+
+#include <algorithm>
+#include <catch.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEMPLATE_TEST_CASE("Timer queues pop expired nodes in deadline order", "[TimerQueue]", TimerHeap, FlatTimerQueue,
+                   LadderTimerQueue)
+{
+  TestType queue;
+  std::vector<TimerNode> nodes(100);
+  std::mt19937 rng(7);
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+  {
+    nodes[i].id = i + 1;
+    nodes[i].deadline = static_cast<std::int64_t>(rng() % 1000);
+    queue.push(&nodes[i]);
+  }
+  REQUIRE(queue.size() == 100);
+
+  for (std::size_t i = 0; i < nodes.size(); i += 3)
+  {
+    queue.erase(&nodes[i]);  // 删除三分之一
+    REQUIRE_FALSE(nodes[i].queued());
+  }
+  REQUIRE(queue.size() == 66);
+
+  std::int64_t expected_min = 1000;
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (i % 3 != 0)
+    {
+      expected_min = std::min(expected_min, nodes[i].deadline);
+    }
+  }
+  REQUIRE(queue.earliest() == expected_min);
+
+  std::vector<TimerNode *> out;
+  const std::size_t n = queue.pop_expired(499, out);
+  REQUIRE(n == out.size());
+  for (std::size_t i = 0; i < out.size(); ++i)
+  {
+    REQUIRE(out[i]->deadline <= 499);
+    REQUIRE_FALSE(out[i]->queued());
+    if (i > 0)
+    {
+      REQUIRE(out[i - 1]->deadline <= out[i]->deadline);
+    }
+  }
+  REQUIRE(queue.earliest() > 499);
+  REQUIRE(queue.pop_expired(499, out) == 0);
+
+  queue.pop_expired(1000, out);
+  REQUIRE(out.size() == 66);
+  REQUIRE(queue.empty());
+  REQUIRE(queue.earliest() == INT64_MAX);
+}
+
+TEMPLATE_TEST_CASE("Timer queues match the heap under mixed operations", "[TimerQueue]", FlatTimerQueue,
+                   LadderTimerQueue)
+{
+  TimerHeap reference;
+  TestType queue;
+  std::vector<TimerNode> a(5000);
+  std::vector<TimerNode> b(5000);
+  std::mt19937_64 rng(99);
+  std::int64_t now = 0;
+  std::vector<TimerNode *> out_a;
+  std::vector<TimerNode *> out_b;
+
+  for (int round = 0; round < 20000; ++round)
+  {
+    const std::size_t i = static_cast<std::size_t>(rng() % a.size());
+    const unsigned op = static_cast<unsigned>(rng() % 4);
+    if (op < 2 && !a[i].queued())
+    {
+      // 偏斜分布: 多数在近期, 少数远至 10^9 tick 之后
+      const std::int64_t span = (rng() % 10 == 0) ? 1000000000 : 1000;
+      a[i].deadline = b[i].deadline = now + static_cast<std::int64_t>(rng() % static_cast<std::uint64_t>(span));
+      a[i].id = b[i].id = i + 1;
+      reference.push(&a[i]);
+      queue.push(&b[i]);
+    }
+    else if (op == 2 && a[i].queued())
+    {
+      reference.erase(&a[i]);
+      queue.erase(&b[i]);
+    }
+    else
+    {
+      now += static_cast<std::int64_t>(rng() % 200);
+      out_a.clear();
+      out_b.clear();
+      reference.pop_expired(now, out_a);
+      queue.pop_expired(now, out_b);
+      REQUIRE(out_a.size() == out_b.size());
+      for (std::size_t k = 0; k < out_a.size(); ++k)
+      {
+        REQUIRE(out_a[k]->deadline == out_b[k]->deadline);
+      }
+    }
+    REQUIRE(reference.size() == queue.size());
+    REQUIRE(reference.earliest() == queue.earliest());
+  }
+}
+
+TEMPLATE_TEST_CASE("Timer queues remove nodes by predicate", "[TimerQueue]", TimerHeap, FlatTimerQueue,
+                   LadderTimerQueue)
+{
+  TestType queue;
+  std::vector<TimerNode> nodes(300);
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+  {
+    nodes[i].id = i + 1;
+    nodes[i].deadline = static_cast<std::int64_t>((i * 7919) % 1000);
+    queue.push(&nodes[i]);
+  }
+  std::vector<TimerNode *> out;
+  queue.pop_expired(-1, out);  // 让梯形队列建立梯级
+  REQUIRE(queue.remove_if([](const TimerNode *node) { return node->id % 2 == 0; }) == 150);
+  REQUIRE(queue.size() == 150);
+
+  queue.pop_expired(1000, out);
+  REQUIRE(out.size() == 150);
+  for (std::size_t i = 0; i < out.size(); ++i)
+  {
+    REQUIRE(out[i]->id % 2 == 1);
+    if (i > 0)
+    {
+      REQUIRE(out[i - 1]->deadline <= out[i]->deadline);
+    }
+  }
+  REQUIRE(queue.empty());
+}
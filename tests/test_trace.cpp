@@ -0,0 +1,65 @@
+// 单独的可执行文件: 以 SIMPLE_TIMER_TRACE 编译, 避免与 timertest 中未开启追踪的代码违反 ODR
+#define CATCH_CONFIG_MAIN
+#include <simple_timer/timer_scheduler.h>
+
+#include <atomic>
+#include <catch.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace std::chrono;
+
+namespace
+{
+std::size_t count(const std::string &s, const std::string &what)
+{
+  std::size_t n = 0;
+  for (std::size_t pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + what.size()))
+  {
+    ++n;
+  }
+  return n;
+}
+}  // namespace
+
+TEST_CASE("Trace records SimpleTimer fire, task, pause, resume and interval events", "[TimerTrace]")
+{
+  TimerTrace::clear();
+  SimpleTimer timer(milliseconds(10));
+  timer.start([]() {});
+  std::this_thread::sleep_for(milliseconds(55));
+  timer.pause();
+  timer.resume();
+  timer.set_interval(milliseconds(20));
+  timer.stop();
+
+  const std::string json = TimerTrace::chrome_json();
+  REQUIRE(json.find("{\"traceEvents\":[") == 0);
+  REQUIRE(count(json, "\"name\":\"fire\"") >= 3);
+  REQUIRE(count(json, "\"ph\":\"B\"") == count(json, "\"ph\":\"E\""));
+  REQUIRE(count(json, "\"name\":\"pause\"") == 1);
+  REQUIRE(count(json, "\"name\":\"resume\"") == 1);
+  REQUIRE(json.find("\"interval_ns\":20000000") != std::string::npos);
+}
+
+TEST_CASE("Trace records scheduler tasks and keeps only the newest records", "[TimerTrace]")
+{
+  TimerTrace::clear();
+  {
+    TimerScheduler scheduler;
+    std::atomic<int> fired{0};
+    for (int i = 0; i < 3000; ++i)
+    {
+      scheduler.schedule_after(milliseconds(5), [&]() { ++fired; });
+    }
+    std::this_thread::sleep_for(milliseconds(100));
+    REQUIRE(fired == 3000);
+  }
+
+  const std::string json = TimerTrace::chrome_json();
+  const std::size_t events = count(json, "\"pid\":1");
+  REQUIRE(events <= SIMPLE_TIMER_TRACE_CAPACITY);  // 9000 条记录只保留环形缓冲区容量
+  REQUIRE(events >= SIMPLE_TIMER_TRACE_CAPACITY - 3);
+  REQUIRE(count(json, "\"name\":\"fire\"") > 1000);
+}